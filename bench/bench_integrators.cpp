@@ -0,0 +1,127 @@
+// Accuracy-vs-cost comparison of the single-neuron integrators against a
+// fine-dt RK4 reference. Spike times include the in-step offset reported by
+// step_izhikevich, so interpolating schemes are credited for it.
+
+#include "izhnet/core/timer.hpp"
+#include "izhnet/core/types.hpp"
+#include "izhnet/model/izhikevich.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct NeuronType {
+    const char* name;
+    double a;
+    double b;
+    double c;
+    double d;
+    double I;
+};
+
+struct Scheme {
+    const char* name;
+    izhnet::Integrator integrator;
+    bool consistent_integration;
+};
+
+constexpr double kDurationMs = 1000.0;
+constexpr double kReferenceDtMs = 0.001;
+
+izhnet::IzhParams params_for(const NeuronType& type, const Scheme& scheme)
+{
+    izhnet::IzhParams p = izhnet::default_params();
+    p.a = type.a;
+    p.b = type.b;
+    p.c = type.c;
+    p.d = type.d;
+    p.V_min = std::numeric_limits<double>::lowest();
+    p.integrator = scheme.integrator;
+    p.consistent_integration = scheme.consistent_integration;
+    return p;
+}
+
+std::vector<double> spike_times(const izhnet::IzhParams& p, double I, double dt_ms)
+{
+    const auto steps = static_cast<std::uint64_t>(std::llround(kDurationMs / dt_ms));
+    double V = -65.0;
+    double U = p.b * V;
+    std::vector<double> times;
+    for (std::uint64_t step = 0; step < steps; ++step) {
+        double offset_ms = 0.0;
+        if (izhnet::step_izhikevich(V, U, I, dt_ms, p, offset_ms)) {
+            times.push_back(static_cast<double>(step) * dt_ms + offset_ms);
+        }
+    }
+    return times;
+}
+
+} // namespace
+
+int main()
+{
+    const std::vector<NeuronType> types {
+        { "RS", 0.02, 0.2, -65.0, 8.0, 10.0 },
+        { "IB", 0.02, 0.2, -55.0, 4.0, 10.0 },
+        { "CH", 0.02, 0.2, -50.0, 2.0, 10.0 },
+        { "FS", 0.10, 0.2, -65.0, 2.0, 10.0 },
+    };
+    const std::vector<Scheme> schemes {
+        { "euler", izhnet::Integrator::Euler, true },
+        { "published", izhnet::Integrator::Euler, false },
+        { "rk2", izhnet::Integrator::RK2, true },
+        { "rk4", izhnet::Integrator::RK4, true },
+        { "expeuler", izhnet::Integrator::ExponentialEuler, true },
+    };
+    const std::vector<double> dts { 0.05, 0.1, 0.25, 0.5, 1.0 };
+    const Scheme reference_scheme { "rk4", izhnet::Integrator::RK4, true };
+
+    std::cout
+        << "# reference: rk4 dt=" << kReferenceDtMs << " ms, duration=" << kDurationMs << " ms\n"
+        << "type scheme dt_ms ref_spikes spikes mean_abs_err_ms max_abs_err_ms ns_per_step\n";
+
+    for (const NeuronType& type : types) {
+        const std::vector<double> reference = spike_times(params_for(type, reference_scheme), type.I, kReferenceDtMs);
+
+        for (const Scheme& scheme : schemes) {
+            const izhnet::IzhParams p = params_for(type, scheme);
+            for (const double dt_ms : dts) {
+                izhnet::Timer timer;
+                std::vector<double> times;
+                int repeats = 0;
+                do {
+                    times = spike_times(p, type.I, dt_ms);
+                    ++repeats;
+                } while (timer.elapsed_seconds() < 0.05);
+                const double steps = kDurationMs / dt_ms * repeats;
+                const double ns_per_step = timer.elapsed_seconds() * 1e9 / steps;
+
+                // Spikes are paired in order; unmatched spikes only show in the counts.
+                const std::size_t matched = std::min(times.size(), reference.size());
+                double sum_err = 0.0;
+                double max_err = 0.0;
+                for (std::size_t i = 0; i < matched; ++i) {
+                    const double err = std::abs(times[i] - reference[i]);
+                    sum_err += err;
+                    max_err = std::max(max_err, err);
+                }
+
+                std::cout
+                    << type.name << " " << scheme.name << " "
+                    << std::fixed << std::setprecision(2) << dt_ms << " "
+                    << reference.size() << " " << times.size() << " "
+                    << std::setprecision(4) << (matched > 0 ? sum_err / static_cast<double>(matched) : 0.0) << " "
+                    << max_err << " "
+                    << std::setprecision(1) << ns_per_step << "\n";
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "izhnet/analysis/metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace izhnet {
+
+SpikeMetrics compute_spike_metrics(
+    const std::vector<SpikeEvent>& spikes,
+    std::uint32_t neuron_count,
+    std::uint32_t steps,
+    double dt_ms,
+    std::uint32_t bin_steps)
+{
+    if (dt_ms <= 0.0) {
+        throw std::invalid_argument("dt_ms must be > 0");
+    }
+    if (bin_steps == 0) {
+        throw std::invalid_argument("bin_steps must be > 0");
+    }
+
+    SpikeMetrics metrics;
+    metrics.total_spikes = spikes.size();
+    if (neuron_count == 0 || steps == 0) {
+        return metrics;
+    }
+
+    const std::size_t bin_count = (static_cast<std::size_t>(steps) + bin_steps - 1U) / bin_steps;
+    std::vector<std::uint64_t> bin_spikes(bin_count, 0U);
+    std::vector<std::uint64_t> seen((static_cast<std::size_t>(neuron_count) + 63U) / 64U, 0U);
+
+    for (const SpikeEvent& event : spikes) {
+        if (event.neuron_id >= neuron_count || event.step >= steps) {
+            throw std::out_of_range("spike event outside [0, neuron_count) x [0, steps)");
+        }
+        ++bin_spikes[event.step / bin_steps];
+        seen[event.neuron_id / 64U] |= std::uint64_t { 1U } << (event.neuron_id % 64U);
+    }
+
+    for (const std::uint64_t word : seen) {
+        metrics.active_neurons += static_cast<std::uint32_t>(std::popcount(word));
+    }
+
+    const double duration_s = static_cast<double>(steps) * dt_ms * 1e-3;
+    metrics.mean_rate_hz = static_cast<double>(spikes.size()) / (static_cast<double>(neuron_count) * duration_s);
+
+    metrics.population_rate_hz.resize(bin_count);
+    for (std::size_t bin = 0; bin < bin_count; ++bin) {
+        const std::size_t bin_begin = bin * bin_steps;
+        const std::size_t width = std::min<std::size_t>(bin_steps, static_cast<std::size_t>(steps) - bin_begin);
+        const double bin_s = static_cast<double>(width) * dt_ms * 1e-3;
+        metrics.population_rate_hz[bin] =
+            static_cast<double>(bin_spikes[bin]) / (static_cast<double>(neuron_count) * bin_s);
+        metrics.peak_population_rate_hz = std::max(metrics.peak_population_rate_hz, metrics.population_rate_hz[bin]);
+    }
+
+    return metrics;
+}
+
+} // namespace izhnet
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "izhnet/core/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace izhnet {
+
+struct SpikeMetrics {
+    std::uint64_t total_spikes = 0;
+    std::uint32_t active_neurons = 0;      // neurons with at least one spike
+    double mean_rate_hz = 0.0;             // per neuron, over the whole run
+    double peak_population_rate_hz = 0.0;  // per neuron, highest bin
+    std::vector<double> population_rate_hz; // per neuron, one entry per bin
+};
+
+// Single pass over a step-ordered spike list; cost scales with the number
+// of events, not with neuron_count * steps.
+SpikeMetrics compute_spike_metrics(
+    const std::vector<SpikeEvent>& spikes,
+    std::uint32_t neuron_count,
+    std::uint32_t steps,
+    double dt_ms,
+    std::uint32_t bin_steps = 10);
+
+} // namespace izhnet
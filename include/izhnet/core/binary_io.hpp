@@ -0,0 +1,32 @@
+#pragma once
+
+#include <fstream>
+
+namespace izhnet {
+
+// Raw little-endian field I/O shared by the trace and checkpoint formats.
+template <class T>
+void write_pod(std::ofstream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+bool read_pod(std::ifstream& in, T& value)
+{
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return static_cast<bool>(in);
+}
+
+// Destructor helper for the background file writers: errors are only
+// reported through an explicit close(), never from a destructor.
+template <class Writer>
+void close_quietly(Writer& writer) noexcept
+{
+    try {
+        writer.close();
+    } catch (...) {
+    }
+}
+
+} // namespace izhnet
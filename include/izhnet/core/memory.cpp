@@ -0,0 +1,155 @@
+#include "izhnet/core/memory.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace izhnet {
+
+namespace {
+
+enum class Backing : std::uint32_t {
+    Heap,
+    Mapped
+};
+
+// Stored in the cache line just before every returned pointer, so that
+// deallocation needs neither the element count nor the policy in effect
+// at allocation time.
+struct alignas(kCacheLineBytes) BlockHeader {
+    void* base = nullptr;         // heap block or start of the mapping, which may precede the header
+    std::size_t mapped_bytes = 0; // whole mapping length
+    Backing backing = Backing::Heap;
+};
+
+static_assert(sizeof(BlockHeader) == kCacheLineBytes);
+
+std::atomic<HugePages> g_huge_pages { HugePages::Off };
+
+std::size_t round_up(std::size_t value, std::size_t multiple)
+{
+    return ((value + multiple - 1U) / multiple) * multiple;
+}
+
+void* heap_allocate(std::size_t bytes)
+{
+#if defined(_WIN32)
+    return _aligned_malloc(bytes, kCacheLineBytes);
+#else
+    return std::aligned_alloc(kCacheLineBytes, round_up(bytes, kCacheLineBytes));
+#endif
+}
+
+void heap_deallocate(void* ptr)
+{
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+#if defined(__linux__)
+// Returns where the block header goes, or nullptr. header.base and
+// header.mapped_bytes receive the whole mapping, for munmap.
+void* map_anonymous(std::size_t bytes, HugePages policy, BlockHeader& header)
+{
+#if defined(MAP_HUGETLB)
+    if (policy == HugePages::Explicit) {
+        const std::size_t length = round_up(bytes, kHugePageBytes);
+        void* ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED) {
+            header.base = ptr;
+            header.mapped_bytes = length;
+            return ptr;
+        }
+    }
+#endif
+    // THP only backs 2 MiB-aligned ranges and mmap gives no such alignment,
+    // so map one huge page extra and start the payload on a huge-page
+    // boundary, with the header in the cache line before it. The slack is
+    // never touched and costs only address space.
+    const long page = sysconf(_SC_PAGESIZE);
+    const std::size_t length = round_up(bytes + kHugePageBytes, page > 0 ? static_cast<std::size_t>(page) : 4096U);
+    void* ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        return nullptr;
+    }
+#if defined(MADV_HUGEPAGE)
+    (void)madvise(ptr, length, MADV_HUGEPAGE);
+#endif
+    header.base = ptr;
+    header.mapped_bytes = length;
+    const auto raw = reinterpret_cast<std::uintptr_t>(ptr);
+    const std::uintptr_t payload = round_up(raw + sizeof(BlockHeader), kHugePageBytes);
+    return reinterpret_cast<void*>(payload - sizeof(BlockHeader));
+}
+#endif
+
+} // namespace
+
+void set_huge_pages(HugePages policy)
+{
+    g_huge_pages.store(policy, std::memory_order_relaxed);
+}
+
+HugePages huge_pages()
+{
+    return g_huge_pages.load(std::memory_order_relaxed);
+}
+
+void* aligned_allocate(std::size_t bytes)
+{
+    const std::size_t total = bytes + sizeof(BlockHeader);
+    if (total < bytes) {
+        throw std::bad_alloc();
+    }
+
+    BlockHeader header;
+    void* start = nullptr;
+#if defined(__linux__)
+    const HugePages policy = huge_pages();
+    if (policy != HugePages::Off && total >= kHugePageBytes) {
+        start = map_anonymous(total, policy, header);
+        header.backing = Backing::Mapped;
+    }
+#endif
+    if (start == nullptr) {
+        header.base = heap_allocate(total);
+        header.mapped_bytes = 0;
+        header.backing = Backing::Heap;
+        start = header.base;
+    }
+    if (start == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    auto* block = static_cast<BlockHeader*>(start);
+    *block = header;
+    return block + 1;
+}
+
+void aligned_deallocate(void* ptr) noexcept
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    const BlockHeader header = *(static_cast<BlockHeader*>(ptr) - 1);
+#if defined(__linux__)
+    if (header.backing == Backing::Mapped) {
+        (void)munmap(header.base, header.mapped_bytes);
+        return;
+    }
+#endif
+    heap_deallocate(header.base);
+}
+
+} // namespace izhnet
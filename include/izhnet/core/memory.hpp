@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace izhnet {
+
+inline constexpr std::size_t kCacheLineBytes = 64;
+inline constexpr std::size_t kHugePageBytes = std::size_t { 2 } << 20U;
+
+enum class HugePages {
+    Off,         // plain 64-byte aligned heap memory
+    Transparent, // anonymous mapping advised with MADV_HUGEPAGE
+    Explicit     // MAP_HUGETLB first, falling back to Transparent
+};
+
+// Process-wide policy for buffers at least kHugePageBytes large; smaller
+// buffers always come from the heap.
+void set_huge_pages(HugePages policy);
+HugePages huge_pages();
+
+// Returns 64-byte aligned memory; release with aligned_deallocate.
+void* aligned_allocate(std::size_t bytes);
+void aligned_deallocate(void* ptr) noexcept;
+
+template <class T>
+class AlignedAllocator {
+public:
+    using value_type = T;
+
+    AlignedAllocator() noexcept = default;
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n)
+    {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(aligned_allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t) noexcept { aligned_deallocate(ptr); }
+
+    template <class U>
+    bool operator==(const AlignedAllocator<U>&) const noexcept { return true; }
+};
+
+template <class T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+struct BufferFootprint {
+    std::string name;
+    std::size_t bytes = 0;
+};
+
+struct MemoryReport {
+    std::vector<BufferFootprint> buffers;
+
+    void add(std::string name, std::size_t bytes) { buffers.push_back(BufferFootprint { std::move(name), bytes }); }
+    void append(const MemoryReport& other) { buffers.insert(buffers.end(), other.buffers.begin(), other.buffers.end()); }
+
+    std::size_t total_bytes() const
+    {
+        std::size_t total = 0;
+        for (const BufferFootprint& buffer : buffers) {
+            total += buffer.bytes;
+        }
+        return total;
+    }
+};
+
+template <class Vec>
+std::size_t capacity_bytes(const Vec& values)
+{
+    return values.capacity() * sizeof(typename Vec::value_type);
+}
+
+} // namespace izhnet
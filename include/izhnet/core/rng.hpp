@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace izhnet {
+
+inline std::uint64_t splitmix64(std::uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27U)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31U);
+}
+
+// Independent seed for a named sub-stream, so adding a consumer does not
+// shift the draws of the existing ones.
+inline std::uint64_t derive_seed(std::uint64_t seed, std::uint64_t stream)
+{
+    return splitmix64(seed ^ splitmix64(stream));
+}
+
+// Uniform in (0, 1].
+inline double uniform_open_closed(std::mt19937_64& rng)
+{
+    return (static_cast<double>(rng() >> 11U) + 1.0) * 0x1.0p-53;
+}
+
+// Failures before the next success of a Bernoulli(p) sequence, given
+// log1m_p = log(1 - p). Lets sparse event streams skip empty trials.
+inline std::uint64_t geometric_skip(std::mt19937_64& rng, double log1m_p)
+{
+    const double skip = std::floor(std::log(uniform_open_closed(rng)) / log1m_p);
+    return (skip < 1.8e19) ? static_cast<std::uint64_t>(skip) : UINT64_MAX;
+}
+
+} // namespace izhnet
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <chrono>
+
+namespace izhnet {
+
+class Timer {
+public:
+    using clock = std::chrono::steady_clock;
+
+    Timer() : start_(clock::now()) {}
+
+    void reset() { start_ = clock::now(); }
+
+    double elapsed_seconds() const { return std::chrono::duration<double>(clock::now() - start_).count(); }
+
+private:
+    clock::time_point start_;
+};
+
+} // namespace izhnet
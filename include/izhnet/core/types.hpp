@@ -1,5 +1,7 @@
 #pragma once
 
+#include "izhnet/core/memory.hpp"
+
 #include <cstddef>
 #include <cstdint>
 #include <vector>
@@ -7,6 +9,13 @@
 namespace izhnet 
 {
 
+enum class Integrator : std::uint8_t {
+    Euler,           // explicit Euler, or the published scheme (see consistent_integration)
+    RK2,             // explicit midpoint, with interpolated threshold crossing
+    RK4,             // classic Runge-Kutta, with interpolated threshold crossing
+    ExponentialEuler // exponential Euler for V, exact U for the new V
+};
+
 struct IzhParams {
     double V_th = 30.0;    // spike threshold
     double I_e = 0.0;     // constant input current (R=1)
@@ -16,6 +25,7 @@ struct IzhParams {
     double c = -65.0;       // after-spike reset value of V_m
     double d = 8.0;       // after-spike reset value of U_m
     bool consistent_integration = true;    // Use of standard integration technique
+    Integrator integrator = Integrator::Euler;  // non-Euler schemes ignore consistent_integration
 };
 
 struct SimConfig {
@@ -32,12 +42,12 @@ struct SpikeEvent {
 
 struct NetworkState 
 {
-    std::vector<double> V; // membrane potential
-    std::vector<double> U; // recovery variables
+    AlignedVector<double> V; // membrane potential
+    AlignedVector<double> U; // recovery variables
 
-    std::vector<double> I;
+    AlignedVector<double> I;
 
-    std::vector<std::uint8_t> spiked;
+    AlignedVector<std::uint8_t> spiked;
 
     void resize(std::size_t N) {
         V.resize(N);
@@ -47,6 +57,15 @@ struct NetworkState
     }
 
     std::size_t size() const { return V.size(); };
+
+    MemoryReport memory_report() const {
+        MemoryReport report;
+        report.add("state.V", capacity_bytes(V));
+        report.add("state.U", capacity_bytes(U));
+        report.add("state.I", capacity_bytes(I));
+        report.add("state.spiked", capacity_bytes(spiked));
+        return report;
+    }
 };
 
 inline IzhParams default_params() { return IzhParams{}; }
@@ -0,0 +1,459 @@
+#include "izhnet/io/raster_renderer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#if IZHNET_HAS_OPENMP
+#include <omp.h>
+#endif
+
+namespace izhnet {
+
+namespace {
+
+// Per-thread histogram. Row r counts neuron ids [r * neurons_per_row,
+// (r + 1) * neurons_per_row); rows are folded pairwise when the span grows.
+struct RasterTile {
+    std::uint64_t neurons_per_row = 1;
+    std::uint32_t max_id = 0;
+    std::uint64_t binned = 0;
+    std::uint64_t skipped = 0;
+    std::vector<std::uint32_t> counts;
+    std::vector<std::uint64_t> column_spikes;
+};
+
+bool parse_spike_line(const char* begin, const char* end, double& time_ms, std::uint32_t& neuron_id)
+{
+    const auto time_res = std::from_chars(begin, end, time_ms);
+    if (time_res.ec != std::errc() || time_res.ptr == end || *time_res.ptr != ',') {
+        return false;
+    }
+    const auto id_res = std::from_chars(time_res.ptr + 1, end, neuron_id);
+    return id_res.ec == std::errc();
+}
+
+void fold_rows(RasterTile& tile, std::uint32_t width, std::uint32_t height)
+{
+    for (std::uint32_t row = 0; row < height; row += 2U) {
+        std::uint32_t* dst = tile.counts.data() + static_cast<std::size_t>(row / 2U) * width;
+        const std::uint32_t* lo = tile.counts.data() + static_cast<std::size_t>(row) * width;
+        const std::uint32_t* hi = (row + 1U < height) ? lo + width : nullptr;
+        for (std::uint32_t col = 0; col < width; ++col) {
+            dst[col] = lo[col] + (hi != nullptr ? hi[col] : 0U);
+        }
+    }
+    const std::size_t kept = static_cast<std::size_t>((height + 1U) / 2U) * width;
+    std::fill(tile.counts.begin() + static_cast<std::ptrdiff_t>(kept), tile.counts.end(), 0U);
+    tile.neurons_per_row *= 2U;
+}
+
+void bin_range(
+    const char* begin,
+    const char* end,
+    RasterTile& tile,
+    const RasterOptions& options,
+    double start_ms,
+    double end_ms,
+    bool fixed_rows)
+{
+    const double cols_per_ms = static_cast<double>(options.width) / (end_ms - start_ms);
+    const std::uint64_t height = options.height;
+
+    while (begin < end) {
+        const char* line_end = std::find(begin, end, '\n');
+        double time_ms = 0.0;
+        std::uint32_t neuron_id = 0;
+        const bool parsed = parse_spike_line(begin, line_end, time_ms, neuron_id);
+        begin = (line_end == end) ? end : line_end + 1;
+        if (!parsed) {
+            continue; // header or blank line
+        }
+
+        if (time_ms < start_ms || time_ms > end_ms ||
+            (fixed_rows && neuron_id >= options.neuron_count)) {
+            ++tile.skipped;
+            continue;
+        }
+        while (!fixed_rows && neuron_id >= tile.neurons_per_row * height) {
+            fold_rows(tile, options.width, options.height);
+        }
+
+        const std::uint32_t col = std::min(
+            options.width - 1U,
+            static_cast<std::uint32_t>((time_ms - start_ms) * cols_per_ms));
+        const std::size_t row = static_cast<std::size_t>(neuron_id / tile.neurons_per_row);
+        ++tile.counts[row * options.width + col];
+        ++tile.column_spikes[col];
+        tile.max_id = std::max(tile.max_id, neuron_id);
+        ++tile.binned;
+    }
+}
+
+// Third column of a spike line, if the line has one.
+bool parse_step(const char* begin, const char* end, std::uint32_t& step)
+{
+    const char* first = std::find(begin, end, ',');
+    first = (first == end) ? end : std::find(first + 1, end, ',');
+    if (first == end) {
+        return false;
+    }
+    return std::from_chars(first + 1, end, step).ec == std::errc();
+}
+
+// Latest spike time in the file. Rows are ordered by step, but interpolated
+// times within the last step need not be, so every line of that step is
+// read. Files without a step column are taken as ordered by time.
+double last_time_ms(const std::string& csv_path)
+{
+    std::ifstream in(csv_path, std::ios::in | std::ios::binary);
+    in.seekg(0, std::ios::end);
+    const std::streamoff size = in.tellg();
+    if (size <= 0) {
+        return -1.0;
+    }
+
+    for (std::streamoff tail = std::min<std::streamoff>(size, 4096);; tail = std::min<std::streamoff>(size, tail * 2)) {
+        std::string buffer(static_cast<std::size_t>(tail), '\0');
+        in.clear();
+        in.seekg(size - tail);
+        in.read(buffer.data(), tail);
+
+        // Lines from the end; the first one is partial unless the whole file was read.
+        double latest = -1.0;
+        bool have_step = false;
+        std::uint32_t last_step = 0;
+        bool reached_earlier_step = false;
+        std::size_t line_end = buffer.size();
+        while (line_end > 0) {
+            const std::size_t newline = buffer.rfind('\n', line_end - 1U);
+            const std::size_t line_begin = (newline == std::string::npos) ? 0U : newline + 1U;
+            if (line_begin == 0U && tail < size) {
+                break;
+            }
+            const char* begin = buffer.data() + line_begin;
+            const char* end = buffer.data() + line_end;
+            while (end > begin && (end[-1] == '\r' || end[-1] == '\n')) {
+                --end;
+            }
+            line_end = line_begin > 0U ? line_begin - 1U : 0U;
+
+            double time_ms = 0.0;
+            std::uint32_t neuron_id = 0;
+            if (!parse_spike_line(begin, end, time_ms, neuron_id)) {
+                continue; // blank line or header
+            }
+            std::uint32_t step = 0;
+            if (!parse_step(begin, end, step)) {
+                return (latest >= 0.0) ? latest : time_ms;
+            }
+            if (have_step && step != last_step) {
+                reached_earlier_step = true;
+                break;
+            }
+            have_step = true;
+            last_step = step;
+            latest = std::max(latest, time_ms);
+        }
+        if (reached_earlier_step || tail >= size) {
+            return latest;
+        }
+    }
+}
+
+void put_u32_be(std::vector<std::uint8_t>& out, std::uint32_t value)
+{
+    out.push_back(static_cast<std::uint8_t>(value >> 24U));
+    out.push_back(static_cast<std::uint8_t>(value >> 16U));
+    out.push_back(static_cast<std::uint8_t>(value >> 8U));
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+std::uint32_t crc32(const std::uint8_t* data, std::size_t size)
+{
+    static const std::array<std::uint32_t, 256> table = []() {
+        std::array<std::uint32_t, 256> t {};
+        for (std::uint32_t n = 0; n < 256U; ++n) {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1U) ? (0xEDB88320U ^ (c >> 1U)) : (c >> 1U);
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+
+    std::uint32_t crc = 0xFFFFFFFFU;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFFU] ^ (crc >> 8U);
+    }
+    return crc ^ 0xFFFFFFFFU;
+}
+
+void put_png_chunk(std::vector<std::uint8_t>& out, const char* type, const std::vector<std::uint8_t>& payload)
+{
+    put_u32_be(out, static_cast<std::uint32_t>(payload.size()));
+    const std::size_t type_pos = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), payload.begin(), payload.end());
+    put_u32_be(out, crc32(out.data() + type_pos, payload.size() + 4U));
+}
+
+std::vector<std::uint8_t> encode_png(const RasterImage& image)
+{
+    // zlib stream of stored (uncompressed) deflate blocks; scanlines use filter 0.
+    const std::size_t stride = static_cast<std::size_t>(image.width) * 3U;
+    std::vector<std::uint8_t> raw;
+    raw.reserve((stride + 1U) * image.height);
+    for (std::uint32_t y = 0; y < image.height; ++y) {
+        raw.push_back(0U);
+        const auto row = image.rgb.begin() + static_cast<std::ptrdiff_t>(y * stride);
+        raw.insert(raw.end(), row, row + static_cast<std::ptrdiff_t>(stride));
+    }
+
+    std::vector<std::uint8_t> zlib { 0x78U, 0x01U };
+    constexpr std::size_t kMaxStored = 65535U;
+    for (std::size_t pos = 0; pos < raw.size() || pos == 0; pos += kMaxStored) {
+        const std::size_t len = std::min(kMaxStored, raw.size() - pos);
+        const bool last = pos + len >= raw.size();
+        zlib.push_back(last ? 1U : 0U);
+        zlib.push_back(static_cast<std::uint8_t>(len));
+        zlib.push_back(static_cast<std::uint8_t>(len >> 8U));
+        zlib.push_back(static_cast<std::uint8_t>(~len));
+        zlib.push_back(static_cast<std::uint8_t>(~len >> 8U));
+        zlib.insert(zlib.end(), raw.begin() + static_cast<std::ptrdiff_t>(pos),
+            raw.begin() + static_cast<std::ptrdiff_t>(pos + len));
+        if (last) {
+            break;
+        }
+    }
+    std::uint32_t a = 1U;
+    std::uint32_t b = 0U;
+    for (const std::uint8_t byte : raw) {
+        a = (a + byte) % 65521U;
+        b = (b + a) % 65521U;
+    }
+    put_u32_be(zlib, (b << 16U) | a);
+
+    std::vector<std::uint8_t> png { 0x89U, 'P', 'N', 'G', '\r', '\n', 0x1AU, '\n' };
+    std::vector<std::uint8_t> header;
+    put_u32_be(header, image.width);
+    put_u32_be(header, image.height);
+    header.insert(header.end(), { 8U, 2U, 0U, 0U, 0U }); // 8-bit RGB
+    put_png_chunk(png, "IHDR", header);
+    put_png_chunk(png, "IDAT", zlib);
+    put_png_chunk(png, "IEND", {});
+    return png;
+}
+
+} // namespace
+
+RasterSummary render_spike_raster(const std::string& csv_path, const RasterOptions& options, RasterImage& image)
+{
+    if (options.width == 0 || options.height == 0) {
+        throw std::invalid_argument("raster width and height must be > 0");
+    }
+    if (options.chunk_bytes < 4096U) {
+        throw std::invalid_argument("raster chunk_bytes must be >= 4096");
+    }
+
+    std::ifstream in(csv_path, std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("failed to open spike csv: " + csv_path);
+    }
+
+    RasterSummary summary;
+    summary.start_ms = options.start_ms;
+    summary.end_ms = (options.end_ms >= 0.0) ? options.end_ms : last_time_ms(csv_path);
+    if (summary.end_ms <= summary.start_ms) {
+        summary.end_ms = summary.start_ms + 1.0;
+    }
+
+    const bool fixed_rows = options.neuron_count > 0;
+    const std::uint64_t fixed_span = fixed_rows
+        ? std::max<std::uint64_t>(1U, (std::uint64_t { options.neuron_count } + options.height - 1U) / options.height)
+        : 1U;
+
+#if IZHNET_HAS_OPENMP
+    const int thread_count = (options.threads > 0) ? options.threads : omp_get_max_threads();
+#else
+    const int thread_count = 1;
+#endif
+    const std::size_t pixels = static_cast<std::size_t>(options.width) * options.height;
+    std::vector<RasterTile> tiles(static_cast<std::size_t>(thread_count));
+    for (RasterTile& tile : tiles) {
+        tile.neurons_per_row = fixed_span;
+        tile.counts.assign(pixels, 0U);
+        tile.column_spikes.assign(options.width, 0U);
+    }
+
+    std::vector<char> buffer(options.chunk_bytes);
+    std::size_t carry = 0;
+    for (;;) {
+        in.read(buffer.data() + carry, static_cast<std::streamsize>(buffer.size() - carry));
+        const std::size_t filled = carry + static_cast<std::size_t>(in.gcount());
+        if (filled == 0) {
+            break;
+        }
+
+        std::size_t usable = filled;
+        if (in) {
+            const auto last_newline = std::find(buffer.rbegin() + static_cast<std::ptrdiff_t>(buffer.size() - filled),
+                buffer.rend(), '\n');
+            if (last_newline == buffer.rend()) {
+                throw std::runtime_error("spike csv line longer than chunk_bytes");
+            }
+            usable = static_cast<std::size_t>(buffer.rend() - last_newline);
+        }
+
+        // Split at line boundaries so each thread parses whole lines.
+        std::vector<std::size_t> bounds(static_cast<std::size_t>(thread_count) + 1U, usable);
+        bounds[0] = 0;
+        for (int t = 1; t < thread_count; ++t) {
+            std::size_t pos = std::max(bounds[static_cast<std::size_t>(t) - 1U],
+                usable * static_cast<std::size_t>(t) / static_cast<std::size_t>(thread_count));
+            while (pos < usable && pos > 0 && buffer[pos - 1U] != '\n') {
+                ++pos;
+            }
+            bounds[static_cast<std::size_t>(t)] = pos;
+        }
+
+#if IZHNET_HAS_OPENMP
+#pragma omp parallel for num_threads(thread_count) schedule(static, 1)
+#endif
+        for (int t = 0; t < thread_count; ++t) {
+            const std::size_t first = bounds[static_cast<std::size_t>(t)];
+            const std::size_t last = bounds[static_cast<std::size_t>(t) + 1U];
+            bin_range(buffer.data() + first, buffer.data() + last, tiles[static_cast<std::size_t>(t)],
+                options, summary.start_ms, summary.end_ms, fixed_rows);
+        }
+
+        carry = filled - usable;
+        std::copy(buffer.begin() + static_cast<std::ptrdiff_t>(usable),
+            buffer.begin() + static_cast<std::ptrdiff_t>(filled), buffer.begin());
+        if (!in) {
+            break;
+        }
+    }
+
+    // Bring every tile to the widest row span, then reduce.
+    std::uint64_t span = fixed_span;
+    std::uint32_t max_id = 0;
+    for (const RasterTile& tile : tiles) {
+        span = std::max(span, tile.neurons_per_row);
+        max_id = std::max(max_id, tile.max_id);
+        summary.events_binned += tile.binned;
+        summary.events_skipped += tile.skipped;
+    }
+    std::vector<std::uint64_t> counts(pixels, 0U);
+    std::vector<std::uint64_t> column_spikes(options.width, 0U);
+    for (RasterTile& tile : tiles) {
+        while (tile.neurons_per_row < span) {
+            fold_rows(tile, options.width, options.height);
+        }
+        for (std::size_t i = 0; i < pixels; ++i) {
+            counts[i] += tile.counts[i];
+        }
+        for (std::uint32_t col = 0; col < options.width; ++col) {
+            column_spikes[col] += tile.column_spikes[col];
+        }
+    }
+
+    summary.neuron_count = fixed_rows ? options.neuron_count : (summary.events_binned > 0 ? max_id + 1U : 0U);
+    summary.neurons_per_row = static_cast<std::uint32_t>(span);
+
+    const double bin_s = (summary.end_ms - summary.start_ms) / static_cast<double>(options.width) * 1e-3;
+    const double rate_norm = (summary.neuron_count > 0)
+        ? 1.0 / (static_cast<double>(summary.neuron_count) * bin_s)
+        : 0.0;
+    std::uint64_t peak_column = 0;
+    for (const std::uint64_t spikes : column_spikes) {
+        peak_column = std::max(peak_column, spikes);
+    }
+    summary.peak_rate_hz = static_cast<double>(peak_column) * rate_norm;
+
+    // Raster panel: log-scaled density, neuron 0 at the bottom.
+    const auto rows_used = static_cast<std::uint32_t>(std::clamp<std::uint64_t>(
+        (std::uint64_t { summary.neuron_count } + span - 1U) / span, 1U, options.height));
+    const std::uint64_t peak_count = *std::max_element(counts.begin(), counts.end());
+    const double log_peak = std::log1p(static_cast<double>(peak_count));
+    const std::uint32_t panel_gap = (options.rate_height > 0) ? 1U : 0U;
+
+    image.width = options.width;
+    image.height = options.height + panel_gap + options.rate_height;
+    image.rgb.assign(static_cast<std::size_t>(image.width) * image.height * 3U, 255U);
+
+    const auto put = [&](std::uint32_t x, std::uint32_t y, std::uint8_t r, std::uint8_t g, std::uint8_t b) {
+        const std::size_t idx = (static_cast<std::size_t>(y) * image.width + x) * 3U;
+        image.rgb[idx] = r;
+        image.rgb[idx + 1U] = g;
+        image.rgb[idx + 2U] = b;
+    };
+    const auto ink = [](double level, double full) {
+        return static_cast<std::uint8_t>(std::lround(255.0 - level * (255.0 - full)));
+    };
+
+    for (std::uint32_t y = 0; y < options.height; ++y) {
+        const std::size_t row = static_cast<std::size_t>(options.height - 1U - y) * rows_used / options.height;
+        for (std::uint32_t x = 0; x < options.width; ++x) {
+            const std::uint64_t c = counts[row * options.width + x];
+            if (c == 0 || log_peak <= 0.0) {
+                continue;
+            }
+            const double level = std::max(0.25, std::log1p(static_cast<double>(c)) / log_peak);
+            put(x, y, ink(level, 16.0), ink(level, 24.0), ink(level, 64.0));
+        }
+    }
+
+    if (options.rate_height > 0) {
+        for (std::uint32_t x = 0; x < options.width; ++x) {
+            put(x, options.height, 160U, 160U, 160U);
+        }
+        const std::uint32_t base = image.height - 1U;
+        for (std::uint32_t x = 0; x < options.width; ++x) {
+            if (peak_column == 0) {
+                break;
+            }
+            const auto bar = static_cast<std::uint32_t>(std::lround(
+                static_cast<double>(column_spikes[x]) / static_cast<double>(peak_column) *
+                static_cast<double>(options.rate_height - 1U)));
+            for (std::uint32_t h = 0; h <= bar && column_spikes[x] > 0; ++h) {
+                put(x, base - h, 180U, 40U, 40U);
+            }
+        }
+    }
+
+    return summary;
+}
+
+void write_raster_image(const std::string& output_path, const RasterImage& image)
+{
+    const std::filesystem::path path(output_path);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+
+    std::ofstream out(output_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("failed to open image for writing: " + output_path);
+    }
+
+    if (path.extension() == ".png") {
+        const std::vector<std::uint8_t> png = encode_png(image);
+        out.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+    } else {
+        out << "P6\n" << image.width << " " << image.height << "\n255\n";
+        out.write(reinterpret_cast<const char*>(image.rgb.data()), static_cast<std::streamsize>(image.rgb.size()));
+    }
+
+    out.flush();
+    if (!out.good()) {
+        throw std::runtime_error("failed while writing image: " + output_path);
+    }
+}
+
+} // namespace izhnet
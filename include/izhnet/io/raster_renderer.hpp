@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace izhnet {
+
+struct RasterOptions {
+    std::uint32_t width = 1600;        // time bins / image columns
+    std::uint32_t height = 800;        // neuron bins / raster panel rows
+    std::uint32_t rate_height = 200;   // population-rate panel rows; 0 disables it
+    double start_ms = 0.0;
+    double end_ms = -1.0;              // < 0: latest spike time in the file
+    std::uint32_t neuron_count = 0;    // 0: infer from the largest id seen
+    std::size_t chunk_bytes = std::size_t { 32 } << 20U;
+    int threads = 0;                   // OpenMP threads; 0 uses runtime default
+};
+
+struct RasterSummary {
+    std::uint64_t events_binned = 0;
+    std::uint64_t events_skipped = 0;  // outside the time window or neuron range
+    double start_ms = 0.0;
+    double end_ms = 0.0;
+    std::uint32_t neuron_count = 0;
+    std::uint32_t neurons_per_row = 1;
+    double peak_rate_hz = 0.0;         // per neuron, highest time bin
+};
+
+struct RasterImage {
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    std::vector<std::uint8_t> rgb; // row-major, top row first
+};
+
+// Streams a spike CSV (time_ms,neuron_id[,...]) once in fixed-size chunks.
+// Lines are parsed and binned in parallel into per-thread density
+// histograms of width x height pixels plus a per-column spike count.
+// Memory is bounded by chunk_bytes and the histograms, not by spike count.
+// When the neuron count is unknown, rows start at one neuron each and
+// double their span whenever a larger id shows up.
+RasterSummary render_spike_raster(const std::string& csv_path, const RasterOptions& options, RasterImage& image);
+
+// Writes .png (uncompressed deflate) or, for any other extension, binary PPM.
+void write_raster_image(const std::string& output_path, const RasterImage& image);
+
+} // namespace izhnet
@@ -0,0 +1,453 @@
+#include "izhnet/io/spike_archive.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define IZHNET_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define IZHNET_HAS_MMAP 0
+#endif
+
+namespace izhnet {
+
+namespace {
+
+constexpr std::array<char, 8> kArchiveMagic { 'I', 'Z', 'S', 'P', 'I', 'K', 'E', '1' };
+constexpr std::uint32_t kArchiveVersion = 1;
+constexpr std::uint32_t kFlagNeuronIndex = 1U;
+constexpr std::uint32_t kFlagOffsets = 2U;
+
+struct ArchiveHeader {
+    std::array<char, 8> magic = kArchiveMagic;
+    std::uint32_t version = kArchiveVersion;
+    std::uint32_t flags = 0;
+    std::uint32_t neuron_count = 0;
+    std::uint32_t step_count = 0;
+    double dt_ms = 0.0;
+    std::uint64_t spike_count = 0;
+    std::uint32_t index_stride_steps = 0;
+    std::uint32_t reserved = 0;
+    std::uint64_t step_index_offset = 0;
+    std::uint64_t neuron_index_offset = 0;
+};
+
+static_assert(sizeof(ArchiveHeader) == 64);
+static_assert(sizeof(SpikeEvent) == 8);
+
+std::uint64_t block_count(std::uint32_t step_count, std::uint32_t stride)
+{
+    return (static_cast<std::uint64_t>(step_count) + stride - 1U) / stride;
+}
+
+// True when offsets[0..count) never decrease and end exactly at `total`.
+bool valid_offsets(const std::uint64_t* offsets, std::uint64_t count, std::uint64_t total)
+{
+    std::uint64_t previous = 0;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        if (offsets[i] < previous) {
+            return false;
+        }
+        previous = offsets[i];
+    }
+    return previous == total;
+}
+
+template <class T>
+void write_array(std::ofstream& out, const T* data, std::size_t count)
+{
+    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+} // namespace
+
+void write_spike_archive(
+    const std::string& output_path,
+    const std::vector<SpikeEvent>& spikes,
+    std::uint32_t neuron_count,
+    std::uint32_t step_count,
+    double dt_ms,
+    const SpikeArchiveOptions& options,
+    std::span<const float> offsets_ms)
+{
+    if (dt_ms <= 0.0) {
+        throw std::invalid_argument("dt_ms must be > 0");
+    }
+    if (options.index_stride_steps == 0) {
+        throw std::invalid_argument("index_stride_steps must be > 0");
+    }
+    if (!offsets_ms.empty() && offsets_ms.size() != spikes.size()) {
+        throw std::invalid_argument("offsets_ms must be empty or hold one entry per spike");
+    }
+    const bool has_offsets = !offsets_ms.empty();
+
+    const auto by_step = [](const SpikeEvent& lhs, const SpikeEvent& rhs) {
+        return lhs.step < rhs.step || (lhs.step == rhs.step && lhs.neuron_id < rhs.neuron_id);
+    };
+    std::vector<SpikeEvent> sorted;
+    std::vector<float> sorted_offsets;
+    const std::vector<SpikeEvent>* records = &spikes;
+    std::span<const float> record_offsets = offsets_ms;
+    if (!std::is_sorted(spikes.begin(), spikes.end(), by_step)) {
+        // Sort a permutation so the offsets follow their spikes.
+        std::vector<std::size_t> order(spikes.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(),
+            [&](std::size_t lhs, std::size_t rhs) { return by_step(spikes[lhs], spikes[rhs]); });
+        sorted.reserve(spikes.size());
+        for (const std::size_t i : order) {
+            sorted.push_back(spikes[i]);
+            if (has_offsets) {
+                sorted_offsets.push_back(offsets_ms[i]);
+            }
+        }
+        records = &sorted;
+        record_offsets = sorted_offsets;
+    }
+    for (const SpikeEvent& event : *records) {
+        if (event.neuron_id >= neuron_count || event.step >= step_count) {
+            throw std::out_of_range("spike event outside [0, neuron_count) x [0, step_count)");
+        }
+    }
+
+    const std::uint32_t stride = options.index_stride_steps;
+    const std::uint64_t blocks = block_count(step_count, stride);
+    std::vector<std::uint64_t> step_index(blocks + 1U, 0U);
+    {
+        std::size_t pos = 0;
+        for (std::uint64_t block = 0; block <= blocks; ++block) {
+            const std::uint64_t first_step = block * stride;
+            while (pos < records->size() && (*records)[pos].step < first_step) {
+                ++pos;
+            }
+            step_index[block] = pos;
+        }
+    }
+
+    ArchiveHeader header;
+    header.flags = (options.neuron_index ? kFlagNeuronIndex : 0U) | (has_offsets ? kFlagOffsets : 0U);
+    header.neuron_count = neuron_count;
+    header.step_count = step_count;
+    header.dt_ms = dt_ms;
+    header.spike_count = records->size();
+    header.index_stride_steps = stride;
+    header.step_index_offset = sizeof(ArchiveHeader) + records->size() * sizeof(SpikeEvent);
+    header.neuron_index_offset = options.neuron_index
+        ? header.step_index_offset + step_index.size() * sizeof(std::uint64_t)
+        : 0U;
+
+    const std::filesystem::path path(output_path);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+    std::ofstream out(output_path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("failed to open spike archive for writing: " + output_path);
+    }
+
+    write_array(out, &header, 1U);
+    write_array(out, records->data(), records->size());
+    write_array(out, step_index.data(), step_index.size());
+
+    if (options.neuron_index) {
+        // Counting sort by neuron; spikes stay in step order within each neuron.
+        std::vector<std::uint64_t> offsets(static_cast<std::size_t>(neuron_count) + 1U, 0U);
+        for (const SpikeEvent& event : *records) {
+            ++offsets[static_cast<std::size_t>(event.neuron_id) + 1U];
+        }
+        for (std::size_t i = 1; i < offsets.size(); ++i) {
+            offsets[i] += offsets[i - 1U];
+        }
+        std::vector<std::uint32_t> steps(records->size());
+        std::vector<float> neuron_offsets_ms(has_offsets ? records->size() : 0U);
+        std::vector<std::uint64_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < records->size(); ++i) {
+            const SpikeEvent& event = (*records)[i];
+            const std::uint64_t slot = cursor[event.neuron_id]++;
+            steps[slot] = event.step;
+            if (has_offsets) {
+                neuron_offsets_ms[slot] = record_offsets[i];
+            }
+        }
+        write_array(out, offsets.data(), offsets.size());
+        write_array(out, steps.data(), steps.size());
+        if (has_offsets) {
+            write_array(out, record_offsets.data(), record_offsets.size());
+            write_array(out, neuron_offsets_ms.data(), neuron_offsets_ms.size());
+        }
+    } else if (has_offsets) {
+        write_array(out, record_offsets.data(), record_offsets.size());
+    }
+
+    out.flush();
+    if (!out.good()) {
+        throw std::runtime_error("failed while writing spike archive: " + output_path);
+    }
+}
+
+SpikeArchive::SpikeArchive(const std::string& input_path)
+{
+#if IZHNET_HAS_MMAP
+    const int fd = ::open(input_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("failed to open spike archive: " + input_path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("failed to stat spike archive: " + input_path);
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ >= sizeof(ArchiveHeader)) {
+        void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("failed to map spike archive: " + input_path);
+        }
+        // Queries touch a few scattered pages; read-ahead would only waste I/O.
+        (void)::madvise(mapped, size_, MADV_RANDOM);
+        data_ = static_cast<const std::uint8_t*>(mapped);
+    }
+    ::close(fd);
+#else
+    std::ifstream in(input_path, std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("failed to open spike archive: " + input_path);
+    }
+    fallback_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    size_ = fallback_.size();
+    data_ = fallback_.data();
+#endif
+
+    ArchiveHeader header;
+    if (data_ == nullptr || size_ < sizeof(ArchiveHeader)) {
+        release();
+        throw std::runtime_error("truncated spike archive: " + input_path);
+    }
+    std::memcpy(&header, data_, sizeof(header));
+    if (header.magic != kArchiveMagic || header.version != kArchiveVersion) {
+        release();
+        throw std::runtime_error("not a supported izhnet spike archive: " + input_path);
+    }
+
+    const std::uint64_t blocks = (header.index_stride_steps > 0)
+        ? block_count(header.step_count, header.index_stride_steps)
+        : 0U;
+    const bool has_neuron_index = (header.flags & kFlagNeuronIndex) != 0U;
+    const bool has_offsets = (header.flags & kFlagOffsets) != 0U;
+    const std::uint64_t step_index_end = header.step_index_offset + (blocks + 1U) * sizeof(std::uint64_t);
+    const std::uint64_t neuron_index_end = has_neuron_index
+        ? header.neuron_index_offset + (static_cast<std::uint64_t>(header.neuron_count) + 1U) * sizeof(std::uint64_t) +
+            header.spike_count * sizeof(std::uint32_t)
+        : 0U;
+    // Offset columns follow the last index: one per record, and one grouped
+    // like the neuron index when that is present.
+    const std::uint64_t offsets_begin = has_neuron_index ? neuron_index_end : step_index_end;
+    const std::uint64_t offsets_end = has_offsets
+        ? offsets_begin + header.spike_count * sizeof(float) * (has_neuron_index ? 2U : 1U)
+        : 0U;
+    if (header.index_stride_steps == 0 ||
+        header.step_index_offset != sizeof(ArchiveHeader) + header.spike_count * sizeof(SpikeEvent) ||
+        step_index_end > size_ || neuron_index_end > size_ || offsets_end > size_) {
+        release();
+        throw std::runtime_error("corrupt spike archive: " + input_path);
+    }
+
+    info_.neuron_count = header.neuron_count;
+    info_.step_count = header.step_count;
+    info_.dt_ms = header.dt_ms;
+    info_.spike_count = header.spike_count;
+    info_.index_stride_steps = header.index_stride_steps;
+    info_.has_neuron_index = has_neuron_index;
+    info_.has_offsets = has_offsets;
+
+    records_ = reinterpret_cast<const SpikeEvent*>(data_ + sizeof(ArchiveHeader));
+    step_index_ = reinterpret_cast<const std::uint64_t*>(data_ + header.step_index_offset);
+    if (has_neuron_index) {
+        neuron_offsets_ = reinterpret_cast<const std::uint64_t*>(data_ + header.neuron_index_offset);
+        neuron_steps_ = reinterpret_cast<const std::uint32_t*>(neuron_offsets_ + header.neuron_count + 1U);
+    }
+    if (has_offsets) {
+        offsets_ms_ = reinterpret_cast<const float*>(data_ + offsets_begin);
+        if (has_neuron_index) {
+            neuron_offsets_ms_ = offsets_ms_ + header.spike_count;
+        }
+    }
+
+    // Queries index records_ and neuron_steps_ through these arrays without
+    // further checks, so they must be monotone and stay within the records.
+    if (!valid_offsets(step_index_, blocks + 1U, header.spike_count) ||
+        (has_neuron_index &&
+            !valid_offsets(neuron_offsets_, static_cast<std::uint64_t>(header.neuron_count) + 1U, header.spike_count))) {
+        release();
+        throw std::runtime_error("corrupt spike archive index: " + input_path);
+    }
+}
+
+SpikeArchive::~SpikeArchive()
+{
+    release();
+}
+
+SpikeArchive::SpikeArchive(SpikeArchive&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+SpikeArchive& SpikeArchive::operator=(SpikeArchive&& other) noexcept
+{
+    if (this != &other) {
+        release();
+        info_ = other.info_;
+        size_ = other.size_;
+        fallback_ = std::move(other.fallback_);
+        data_ = fallback_.empty() ? other.data_ : fallback_.data();
+        records_ = other.records_;
+        step_index_ = other.step_index_;
+        neuron_offsets_ = other.neuron_offsets_;
+        neuron_steps_ = other.neuron_steps_;
+        offsets_ms_ = other.offsets_ms_;
+        neuron_offsets_ms_ = other.neuron_offsets_ms_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.records_ = nullptr;
+        other.step_index_ = nullptr;
+        other.neuron_offsets_ = nullptr;
+        other.neuron_steps_ = nullptr;
+        other.offsets_ms_ = nullptr;
+        other.neuron_offsets_ms_ = nullptr;
+    }
+    return *this;
+}
+
+void SpikeArchive::release() noexcept
+{
+#if IZHNET_HAS_MMAP
+    if (data_ != nullptr) {
+        ::munmap(const_cast<std::uint8_t*>(data_), size_);
+    }
+#endif
+    fallback_.clear();
+    data_ = nullptr;
+    size_ = 0;
+}
+
+std::span<const SpikeEvent> SpikeArchive::steps(std::uint32_t step_begin, std::uint32_t step_end) const
+{
+    step_end = std::min(step_end, info_.step_count);
+    if (step_begin >= step_end) {
+        return {};
+    }
+
+    // The block index narrows the range; binary search trims the edge blocks.
+    const std::uint32_t stride = info_.index_stride_steps;
+    const SpikeEvent* first = records_ + step_index_[step_begin / stride];
+    const SpikeEvent* last = records_ + step_index_[(static_cast<std::uint64_t>(step_end) + stride - 1U) / stride];
+    first = std::lower_bound(first, last, step_begin,
+        [](const SpikeEvent& event, std::uint32_t step) { return event.step < step; });
+    last = std::lower_bound(first, last, step_end,
+        [](const SpikeEvent& event, std::uint32_t step) { return event.step < step; });
+    return { first, static_cast<std::size_t>(last - first) };
+}
+
+std::span<const float> SpikeArchive::offsets_ms(std::span<const SpikeEvent> records) const
+{
+    if (offsets_ms_ == nullptr || records.empty()) {
+        return {};
+    }
+    return { offsets_ms_ + (records.data() - records_), records.size() };
+}
+
+std::uint32_t SpikeArchive::step_at_or_after(double t_ms) const
+{
+    if (t_ms <= 0.0) {
+        return 0;
+    }
+    // Tolerate the rounding of step * dt_ms printed or recomputed elsewhere.
+    const double step = std::ceil(t_ms / info_.dt_ms - 1e-9);
+    if (step >= static_cast<double>(std::numeric_limits<std::uint32_t>::max())) {
+        return std::numeric_limits<std::uint32_t>::max();
+    }
+    return static_cast<std::uint32_t>(step);
+}
+
+std::span<const SpikeEvent> SpikeArchive::window(double t0_ms, double t1_ms) const
+{
+    return steps(step_at_or_after(t0_ms), step_at_or_after(t1_ms));
+}
+
+std::vector<SpikeEvent> SpikeArchive::neurons(
+    const std::vector<std::uint32_t>& neuron_ids,
+    std::uint32_t step_begin,
+    std::uint32_t step_end,
+    std::vector<float>* offsets_ms) const
+{
+    if (offsets_ms != nullptr) {
+        offsets_ms->clear();
+    }
+    const bool want_offsets = offsets_ms != nullptr && offsets_ms_ != nullptr;
+    for (const std::uint32_t neuron_id : neuron_ids) {
+        if (neuron_id >= info_.neuron_count) {
+            throw std::out_of_range("queried neuron id out of range");
+        }
+    }
+
+    std::vector<SpikeEvent> result;
+    if (neuron_offsets_ != nullptr) {
+        for (const std::uint32_t neuron_id : neuron_ids) {
+            const std::uint32_t* first = neuron_steps_ + neuron_offsets_[neuron_id];
+            const std::uint32_t* last = neuron_steps_ + neuron_offsets_[neuron_id + 1U];
+            first = std::lower_bound(first, last, step_begin);
+            last = std::lower_bound(first, last, step_end);
+            for (const std::uint32_t* it = first; it != last; ++it) {
+                result.push_back(SpikeEvent { neuron_id, *it });
+                if (want_offsets) {
+                    offsets_ms->push_back(neuron_offsets_ms_[it - neuron_steps_]);
+                }
+            }
+        }
+        return result;
+    }
+
+    // No neuron index: one pass over the step range into per-query buckets.
+    std::vector<std::pair<std::uint32_t, std::size_t>> lookup;
+    lookup.reserve(neuron_ids.size());
+    for (std::size_t pos = 0; pos < neuron_ids.size(); ++pos) {
+        lookup.emplace_back(neuron_ids[pos], pos);
+    }
+    std::sort(lookup.begin(), lookup.end());
+
+    // Buckets hold record positions, so offsets can be looked up alongside.
+    std::vector<std::vector<const SpikeEvent*>> buckets(neuron_ids.size());
+    for (const SpikeEvent& event : steps(step_begin, step_end)) {
+        // A repeated id gets the spikes once per occurrence, as with the index.
+        auto it = std::lower_bound(lookup.begin(), lookup.end(),
+            std::pair<std::uint32_t, std::size_t> { event.neuron_id, 0U });
+        for (; it != lookup.end() && it->first == event.neuron_id; ++it) {
+            buckets[it->second].push_back(&event);
+        }
+    }
+    for (const std::vector<const SpikeEvent*>& bucket : buckets) {
+        for (const SpikeEvent* record : bucket) {
+            result.push_back(*record);
+            if (want_offsets) {
+                offsets_ms->push_back(offsets_ms_[record - records_]);
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace izhnet
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "izhnet/core/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace izhnet {
+
+struct SpikeArchiveOptions {
+    std::uint32_t index_stride_steps = 64; // steps per step-index entry
+    bool neuron_index = false;             // also store spike steps grouped by neuron
+};
+
+struct SpikeArchiveInfo {
+    std::uint32_t neuron_count = 0;
+    std::uint32_t step_count = 0;
+    double dt_ms = 0.0;
+    std::uint64_t spike_count = 0;
+    std::uint32_t index_stride_steps = 0;
+    bool has_neuron_index = false;
+    bool has_offsets = false; // sub-step spike times stored (interpolating integrators)
+};
+
+// Binary spike store with a block offset index over steps and an optional
+// per-neuron index. Layout (little-endian, native widths):
+//   header (64 bytes): "IZSPIKE1", u32 version, u32 flags, u32 neuron_count,
+//       u32 step_count, f64 dt_ms, u64 spike_count, u32 index_stride_steps,
+//       u32 reserved, u64 step_index_offset, u64 neuron_index_offset
+//   records: SpikeEvent[spike_count], ordered by step then neuron
+//   step index: u64[ceil(step_count / stride) + 1], first record of each block
+//   neuron index (flag bit 0): u64 offsets[neuron_count + 1], u32 steps[spike_count]
+//   offsets (flag bit 1): f32[spike_count] per record, then f32[spike_count]
+//       in neuron index order when that index is present
+// offsets_ms, when non-empty, holds the sub-step spike time of each spike.
+void write_spike_archive(
+    const std::string& output_path,
+    const std::vector<SpikeEvent>& spikes,
+    std::uint32_t neuron_count,
+    std::uint32_t step_count,
+    double dt_ms,
+    const SpikeArchiveOptions& options = {},
+    std::span<const float> offsets_ms = {});
+
+// Read-only view of an archive. The file is memory-mapped, so a query only
+// faults in the index entries and record pages it actually touches.
+class SpikeArchive {
+public:
+    explicit SpikeArchive(const std::string& input_path);
+    ~SpikeArchive();
+
+    SpikeArchive(SpikeArchive&& other) noexcept;
+    SpikeArchive& operator=(SpikeArchive&& other) noexcept;
+    SpikeArchive(const SpikeArchive&) = delete;
+    SpikeArchive& operator=(const SpikeArchive&) = delete;
+
+    const SpikeArchiveInfo& info() const { return info_; }
+
+    // First step whose time step * dt_ms is >= t_ms.
+    std::uint32_t step_at_or_after(double t_ms) const;
+
+    // Spikes with step in [step_begin, step_end), as a view into the mapping.
+    std::span<const SpikeEvent> steps(std::uint32_t step_begin, std::uint32_t step_end) const;
+
+    // Spikes with step * dt_ms in [t0_ms, t1_ms).
+    std::span<const SpikeEvent> window(double t0_ms, double t1_ms) const;
+
+    // Sub-step offsets of a span returned by steps() or window(); empty
+    // when the archive stores none.
+    std::span<const float> offsets_ms(std::span<const SpikeEvent> records) const;
+
+    // Spikes of the given neurons within [step_begin, step_end), grouped by
+    // neuron in the order given; a repeated id repeats its group. Uses the
+    // neuron index when present and otherwise filters the step range. If
+    // offsets_ms is given, it receives the matching sub-step offsets, or is
+    // left empty when the archive stores none.
+    std::vector<SpikeEvent> neurons(
+        const std::vector<std::uint32_t>& neuron_ids,
+        std::uint32_t step_begin = 0,
+        std::uint32_t step_end = std::numeric_limits<std::uint32_t>::max(),
+        std::vector<float>* offsets_ms = nullptr) const;
+
+private:
+    void release() noexcept;
+
+    SpikeArchiveInfo info_;
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::vector<std::uint8_t> fallback_; // used where mmap is unavailable
+
+    const SpikeEvent* records_ = nullptr;
+    const std::uint64_t* step_index_ = nullptr;
+    const std::uint64_t* neuron_offsets_ = nullptr;
+    const std::uint32_t* neuron_steps_ = nullptr;
+    const float* offsets_ms_ = nullptr;
+    const float* neuron_offsets_ms_ = nullptr;
+};
+
+} // namespace izhnet
@@ -12,11 +12,15 @@ SpikeLogSummary write_spikes_csv(
     const std::string& output_path,
     const std::vector<SpikeEvent>& spikes,
     double dt_ms,
-    bool include_header)
+    bool include_header,
+    std::span<const float> offsets_ms)
 {
     if (dt_ms <= 0.0) {
         throw std::invalid_argument("dt_ms must be > 0");
     }
+    if (!offsets_ms.empty() && offsets_ms.size() != spikes.size()) {
+        throw std::invalid_argument("offsets_ms must be empty or hold one entry per spike");
+    }
 
     const std::filesystem::path path(output_path);
     if (path.has_parent_path()) {
@@ -33,10 +37,13 @@ SpikeLogSummary write_spikes_csv(
     }
     out << std::fixed << std::setprecision(3);
 
-    std::uint32_t max_step = 0;
-    for (const SpikeEvent& event : spikes) {
-        out << (static_cast<double>(event.step) * dt_ms) << "," << event.neuron_id << "," << event.step << "\n";
-        max_step = std::max(max_step, event.step);
+    double max_time_ms = 0.0;
+    for (std::size_t i = 0; i < spikes.size(); ++i) {
+        const SpikeEvent& event = spikes[i];
+        const double offset_ms = offsets_ms.empty() ? 0.0 : offsets_ms[i];
+        const double time_ms = static_cast<double>(event.step) * dt_ms + offset_ms;
+        out << time_ms << "," << event.neuron_id << "," << event.step << "\n";
+        max_time_ms = std::max(max_time_ms, time_ms);
     }
 
     out.flush();
@@ -46,7 +53,7 @@ SpikeLogSummary write_spikes_csv(
 
     return SpikeLogSummary {
         spikes.size(),
-        static_cast<double>(max_step) * dt_ms
+        max_time_ms
     };
 }
 
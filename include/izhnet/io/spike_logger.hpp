@@ -3,6 +3,7 @@
 #include "izhnet/core/types.hpp"
 
 #include <cstddef>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -10,13 +11,16 @@ namespace izhnet {
 
 struct SpikeLogSummary {
     std::size_t events_written = 0;
-    double duration_ms = 0.0;
+    double duration_ms = 0.0; // latest spike time, offsets included
 };
 
+// time_ms is step * dt_ms, plus the matching entry of offsets_ms when that
+// is non-empty (one per spike, from an interpolating integrator).
 SpikeLogSummary write_spikes_csv(
     const std::string& output_path,
     const std::vector<SpikeEvent>& spikes,
     double dt_ms,
-    bool include_header = true);
+    bool include_header = true,
+    std::span<const float> offsets_ms = {});
 
 } // namespace izhnet
@@ -0,0 +1,274 @@
+#include "izhnet/io/trace_recorder.hpp"
+
+#include "izhnet/core/binary_io.hpp"
+
+#include <array>
+#include <filesystem>
+#include <stdexcept>
+
+namespace izhnet {
+
+namespace {
+
+constexpr std::array<char, 8> kTraceMagic { 'I', 'Z', 'T', 'R', 'A', 'C', 'E', '1' };
+constexpr std::uint32_t kTraceVersion = 1;
+
+} // namespace
+
+TraceRecorder::TraceRecorder(const TraceConfig& config, std::uint32_t network_size, double dt_ms)
+    : neurons_(config.neurons)
+    , every_steps_(config.every_steps)
+    , samples_per_block_(config.samples_per_block)
+    , output_path_(config.output_path)
+{
+    if (neurons_.empty()) {
+        throw std::invalid_argument("trace requires at least one neuron");
+    }
+    for (const std::uint32_t neuron_id : neurons_) {
+        if (neuron_id >= network_size) {
+            throw std::out_of_range("traced neuron id out of range");
+        }
+    }
+    if (every_steps_ == 0 || samples_per_block_ == 0) {
+        throw std::invalid_argument("trace every_steps and samples_per_block must be > 0");
+    }
+    if (config.block_count < 2) {
+        throw std::invalid_argument("trace block_count must be >= 2");
+    }
+    if (output_path_.empty()) {
+        throw std::invalid_argument("trace output_path must be set");
+    }
+
+    const std::filesystem::path path(output_path_);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+    out_.open(output_path_, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out_.is_open()) {
+        throw std::runtime_error("failed to open trace file for writing: " + output_path_);
+    }
+
+    out_.write(kTraceMagic.data(), static_cast<std::streamsize>(kTraceMagic.size()));
+    write_pod(out_, kTraceVersion);
+    write_pod(out_, static_cast<std::uint32_t>(neurons_.size()));
+    write_pod(out_, every_steps_);
+    write_pod(out_, samples_per_block_);
+    write_pod(out_, dt_ms);
+    out_.write(reinterpret_cast<const char*>(neurons_.data()),
+        static_cast<std::streamsize>(neurons_.size() * sizeof(std::uint32_t)));
+    if (!out_.good()) {
+        throw std::runtime_error("failed while writing trace header: " + output_path_);
+    }
+
+    const std::size_t column = neurons_.size() * samples_per_block_;
+    blocks_.resize(config.block_count);
+    for (Block& block : blocks_) {
+        block.steps.resize(samples_per_block_);
+        block.V.resize(column);
+        block.U.resize(column);
+        block.I.resize(column);
+    }
+    for (std::size_t idx = 1; idx < blocks_.size(); ++idx) {
+        free_blocks_.push_back(idx);
+    }
+
+    writer_ = std::thread([this]() { writer_loop(); });
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    close_quietly(*this);
+}
+
+void TraceRecorder::record(
+    std::uint32_t step,
+    const AlignedVector<double>& V,
+    const AlignedVector<double>& U,
+    const AlignedVector<double>& syn_current)
+{
+    Block& block = blocks_[current_];
+    const std::size_t sample = block.sample_count;
+    block.steps[sample] = step;
+    for (std::size_t k = 0; k < neurons_.size(); ++k) {
+        const std::size_t src = neurons_[k];
+        const std::size_t dst = k * samples_per_block_ + sample;
+        block.V[dst] = V[src];
+        block.U[dst] = U[src];
+        block.I[dst] = syn_current[src];
+    }
+    ++block.sample_count;
+    ++samples_recorded_;
+
+    if (block.sample_count == samples_per_block_) {
+        submit_current();
+    }
+}
+
+void TraceRecorder::submit_current()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    full_blocks_.push_back(current_);
+    cv_.notify_all();
+    cv_.wait(lock, [this]() { return !free_blocks_.empty(); });
+    current_ = free_blocks_.front();
+    free_blocks_.pop_front();
+    blocks_[current_].sample_count = 0;
+    if (writer_error_) {
+        std::rethrow_exception(writer_error_);
+    }
+}
+
+void TraceRecorder::close()
+{
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (blocks_[current_].sample_count > 0) {
+            full_blocks_.push_back(current_);
+        }
+        closing_ = true;
+    }
+    cv_.notify_all();
+    writer_.join();
+
+    out_.flush();
+    if (!writer_error_ && !out_.good()) {
+        writer_error_ = std::make_exception_ptr(std::runtime_error("failed while writing trace: " + output_path_));
+    }
+    out_.close();
+    if (writer_error_) {
+        std::rethrow_exception(writer_error_);
+    }
+}
+
+void TraceRecorder::writer_loop()
+{
+    for (;;) {
+        std::size_t idx = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return !full_blocks_.empty() || closing_; });
+            if (full_blocks_.empty()) {
+                return;
+            }
+            idx = full_blocks_.front();
+            full_blocks_.pop_front();
+        }
+
+        if (!writer_error_) {
+            try {
+                write_block(blocks_[idx]);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                writer_error_ = std::current_exception();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_blocks_.push_back(idx);
+        }
+        cv_.notify_all();
+    }
+}
+
+void TraceRecorder::write_block(const Block& block)
+{
+    const std::uint32_t count = block.sample_count;
+    write_pod(out_, count);
+    write_pod(out_, std::uint32_t { 0U });
+    out_.write(reinterpret_cast<const char*>(block.steps.data()),
+        static_cast<std::streamsize>(count * sizeof(std::uint32_t)));
+
+    for (const AlignedVector<double>* column : { &block.V, &block.U, &block.I }) {
+        for (std::size_t k = 0; k < neurons_.size(); ++k) {
+            out_.write(reinterpret_cast<const char*>(column->data() + k * samples_per_block_),
+                static_cast<std::streamsize>(count * sizeof(double)));
+        }
+    }
+
+    if (!out_.good()) {
+        throw std::runtime_error("failed while writing trace: " + output_path_);
+    }
+}
+
+MemoryReport TraceRecorder::memory_report() const
+{
+    std::size_t bytes = 0;
+    for (const Block& block : blocks_) {
+        bytes += capacity_bytes(block.steps) + capacity_bytes(block.V) + capacity_bytes(block.U) + capacity_bytes(block.I);
+    }
+    MemoryReport report;
+    report.add("trace.blocks", bytes);
+    return report;
+}
+
+TraceData read_trace_file(const std::string& input_path)
+{
+    std::ifstream in(input_path, std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("failed to open trace file: " + input_path);
+    }
+
+    std::array<char, 8> magic {};
+    std::uint32_t version = 0;
+    std::uint32_t neuron_count = 0;
+    std::uint32_t samples_per_block = 0;
+    TraceData data;
+    in.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+    if (!in || magic != kTraceMagic) {
+        throw std::runtime_error("not an izhnet trace file: " + input_path);
+    }
+    if (!read_pod(in, version) || version != kTraceVersion) {
+        throw std::runtime_error("unsupported trace file version: " + input_path);
+    }
+    if (!read_pod(in, neuron_count) || !read_pod(in, data.every_steps) ||
+        !read_pod(in, samples_per_block) || !read_pod(in, data.dt_ms)) {
+        throw std::runtime_error("truncated trace header: " + input_path);
+    }
+    data.neurons.resize(neuron_count);
+    in.read(reinterpret_cast<char*>(data.neurons.data()),
+        static_cast<std::streamsize>(neuron_count * sizeof(std::uint32_t)));
+    if (!in) {
+        throw std::runtime_error("truncated trace header: " + input_path);
+    }
+
+    std::vector<std::vector<double>> V(neuron_count);
+    std::vector<std::vector<double>> U(neuron_count);
+    std::vector<std::vector<double>> I(neuron_count);
+    std::vector<double> chunk;
+
+    std::uint32_t count = 0;
+    while (read_pod(in, count)) {
+        std::uint32_t reserved = 0;
+        if (!read_pod(in, reserved) || count > samples_per_block) {
+            throw std::runtime_error("corrupt trace block: " + input_path);
+        }
+        const std::size_t first = data.steps.size();
+        data.steps.resize(first + count);
+        in.read(reinterpret_cast<char*>(data.steps.data() + first), static_cast<std::streamsize>(count * sizeof(std::uint32_t)));
+
+        chunk.resize(count);
+        for (auto* columns : { &V, &U, &I }) {
+            for (std::vector<double>& series : *columns) {
+                in.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(count * sizeof(double)));
+                series.insert(series.end(), chunk.begin(), chunk.end());
+            }
+        }
+        if (!in) {
+            throw std::runtime_error("truncated trace block: " + input_path);
+        }
+    }
+
+    for (std::size_t k = 0; k < neuron_count; ++k) {
+        data.V.insert(data.V.end(), V[k].begin(), V[k].end());
+        data.U.insert(data.U.end(), U[k].begin(), U[k].end());
+        data.I.insert(data.I.end(), I[k].begin(), I[k].end());
+    }
+    return data;
+}
+
+} // namespace izhnet
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "izhnet/core/memory.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace izhnet {
+
+struct TraceConfig {
+    std::vector<std::uint32_t> neurons; // traced neuron ids; empty disables tracing
+    std::uint32_t every_steps = 1;      // sample decimation
+    std::string output_path;
+    std::uint32_t samples_per_block = 1024;
+    std::uint32_t block_count = 4;      // preallocated blocks shared with the writer
+};
+
+// Samples V, U and the synaptic input of a fixed set of neurons into
+// preallocated columnar blocks. Full blocks are handed to a background
+// thread that streams them to a binary file, so the step loop only pays for
+// the gather. A sample taken at step s holds the state at the start of that
+// step and the synaptic current delivered during it.
+//
+// File layout (little-endian, native widths):
+//   header: "IZTRACE1", u32 version, u32 neuron_count, u32 every_steps,
+//           u32 samples_per_block, f64 dt_ms, u32 neuron_ids[neuron_count]
+//   block:  u32 sample_count, u32 reserved, u32 steps[sample_count],
+//           then V, U and I, each neuron-major: f64[neuron_count][sample_count]
+class TraceRecorder {
+public:
+    TraceRecorder(const TraceConfig& config, std::uint32_t network_size, double dt_ms);
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    bool due(std::uint32_t step) const { return step % every_steps_ == 0U; }
+
+    void record(
+        std::uint32_t step,
+        const AlignedVector<double>& V,
+        const AlignedVector<double>& U,
+        const AlignedVector<double>& syn_current);
+
+    // Flushes the partial block, joins the writer and rethrows its error.
+    void close();
+
+    std::uint64_t samples_recorded() const { return samples_recorded_; }
+    MemoryReport memory_report() const;
+
+private:
+    struct Block {
+        std::uint32_t sample_count = 0;
+        AlignedVector<std::uint32_t> steps;
+        AlignedVector<double> V;
+        AlignedVector<double> U;
+        AlignedVector<double> I;
+    };
+
+    void submit_current();
+    void writer_loop();
+    void write_block(const Block& block);
+
+    std::vector<std::uint32_t> neurons_;
+    std::uint32_t every_steps_ = 1;
+    std::uint32_t samples_per_block_ = 0;
+    std::uint64_t samples_recorded_ = 0;
+
+    std::vector<Block> blocks_;
+    std::size_t current_ = 0;
+
+    std::ofstream out_;
+    std::string output_path_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::size_t> free_blocks_;
+    std::deque<std::size_t> full_blocks_;
+    bool closing_ = false;
+    bool closed_ = false;
+    std::exception_ptr writer_error_;
+    std::thread writer_;
+};
+
+struct TraceData {
+    std::vector<std::uint32_t> neurons;
+    std::uint32_t every_steps = 1;
+    double dt_ms = 0.0;
+    std::vector<std::uint32_t> steps;
+    // Neuron-major: value of neuron k at sample j is at [k * steps.size() + j].
+    std::vector<double> V;
+    std::vector<double> U;
+    std::vector<double> I;
+};
+
+TraceData read_trace_file(const std::string& input_path);
+
+} // namespace izhnet
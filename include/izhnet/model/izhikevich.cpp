@@ -1,15 +1,62 @@
 #include "izhnet/model/izhikevich.hpp"
 
 #include <algorithm>
+#include <cmath>
 
 namespace izhnet {
 
 static inline double dv_dt(double V, double U, double I) { return 0.04 * (V*V) + (5*V) + 140 - U + I; }
 static inline double du_dt(const IzhParams& p, double V, double U) {return p.a * (p.b * V - U); }
 
-bool step_izhikevich(double& V, double& U, double I, double dt_ms, const IzhParams& p)
+namespace {
+
+// Advances (V, U) by h with no threshold handling.
+void advance(double& V, double& U, double I, double h, const IzhParams& p)
 {
-    if (p.consistent_integration) {
+    switch (p.integrator) {
+    case Integrator::RK2: {
+        const double V_mid = V + 0.5 * h * dv_dt(V, U, I);
+        const double U_mid = U + 0.5 * h * du_dt(p, V, U);
+        V += h * dv_dt(V_mid, U_mid, I);
+        U += h * du_dt(p, V_mid, U_mid);
+        break;
+    }
+    case Integrator::RK4: {
+        const double kV1 = dv_dt(V, U, I);
+        const double kU1 = du_dt(p, V, U);
+        const double kV2 = dv_dt(V + 0.5 * h * kV1, U + 0.5 * h * kU1, I);
+        const double kU2 = du_dt(p, V + 0.5 * h * kV1, U + 0.5 * h * kU1);
+        const double kV3 = dv_dt(V + 0.5 * h * kV2, U + 0.5 * h * kU2, I);
+        const double kU3 = du_dt(p, V + 0.5 * h * kV2, U + 0.5 * h * kU2);
+        const double kV4 = dv_dt(V + h * kV3, U + h * kU3, I);
+        const double kU4 = du_dt(p, V + h * kV3, U + h * kU3);
+        V += h / 6.0 * (kV1 + 2.0 * kV2 + 2.0 * kV3 + kV4);
+        U += h / 6.0 * (kU1 + 2.0 * kU2 + 2.0 * kU3 + kU4);
+        break;
+    }
+    case Integrator::ExponentialEuler: {
+        // V' linearised around V: V += h * phi(J h) * f with phi(z) = (e^z - 1) / z.
+        const double z = (0.08 * V + 5.0) * h;
+        const double phi = (std::abs(z) > 1e-12) ? std::expm1(z) / z : 1.0;
+        V += h * phi * dv_dt(V, U, I);
+        // U' is linear in U: exact decay towards b * V for the new V.
+        const double target = p.b * V;
+        U = target + (U - target) * std::exp(-p.a * h);
+        break;
+    }
+    case Integrator::Euler:
+        V += h * dv_dt(V, U, I);
+        U += h * du_dt(p, V, U);
+        break;
+    }
+}
+
+// One step of the selected scheme with no clamp and no threshold.
+void free_step(double& V, double& U, double I, double dt_ms, const IzhParams& p)
+{
+    if (p.integrator != Integrator::Euler) {
+        advance(V, U, I, dt_ms, p);
+    } else if (p.consistent_integration) {
         // Standard explicit Euler integration.
         const double dV = dv_dt(V, U, I);
         const double dU = du_dt(p, V, U);
@@ -21,15 +68,152 @@ bool step_izhikevich(double& V, double& U, double I, double dt_ms, const IzhPara
         V += 0.5 * dt_ms * dv_dt(V, U, I);
         U += dt_ms * du_dt(p, V, U);
     }
+}
+
+bool reached_threshold(double V, const IzhParams& p)
+{
+    return !(V < p.V_th); // also catches overflow to inf/nan near the peak
+}
+
+// Bounds the crossings resolved in one step, for inputs strong enough to
+// re-cross right after every reset.
+constexpr int kMaxCrossingsPerStep = 16;
+
+// Higher-order step: when the trial step crosses V_th, the crossing is
+// bracketed by bisection on the sub-step length and the reset is applied
+// there. The rest of the step is integrated from the reset state the same
+// way, so a large dt can cross more than once. Returns the crossing count.
+int step_with_crossing(double& V, double& U, double I, double dt_ms, const IzhParams& p, double& spike_offset_ms)
+{
+    int crossings = 0;
+    double elapsed = 0.0;
+    while (crossings < kMaxCrossingsPerStep) {
+        const double remaining = dt_ms - elapsed;
+        double V_end = V;
+        double U_end = U;
+        advance(V_end, U_end, I, remaining, p);
+        if (!reached_threshold(V_end, p)) {
+            V = std::max(V_end, p.V_min);
+            U = U_end;
+            return crossings;
+        }
+
+        double lo = 0.0;
+        double hi = 1.0;
+        double U_cross = U_end;
+        for (int iter = 0; iter < 24; ++iter) {
+            const double mid = 0.5 * (lo + hi);
+            double V_mid = V;
+            double U_mid = U;
+            advance(V_mid, U_mid, I, mid * remaining, p);
+            if (reached_threshold(V_mid, p)) {
+                hi = mid;
+                U_cross = U_mid;
+            } else {
+                lo = mid;
+            }
+        }
+
+        elapsed += hi * remaining;
+        if (crossings == 0) {
+            spike_offset_ms = elapsed;
+        }
+        ++crossings;
+        V = p.c;
+        U = U_cross + p.d;
+    }
+    // Out of budget: the neuron stays at its last reset for the rest of the step.
+    return crossings;
+}
+
+} // namespace
+
+bool step_izhikevich(double& V, double& U, double I, double dt_ms, const IzhParams& p)
+{
+    double spike_offset_ms = 0.0;
+    return step_izhikevich(V, U, I, dt_ms, p, spike_offset_ms) > 0;
+}
+
+int step_izhikevich(double& V, double& U, double I, double dt_ms, const IzhParams& p, double& spike_offset_ms)
+{
+    if (p.integrator != Integrator::Euler) {
+        return step_with_crossing(V, U, I, dt_ms, p, spike_offset_ms);
+    }
+
+    free_step(V, U, I, dt_ms, p);
 
     V = std::max(V, p.V_min);
     if (V >= p.V_th) {
         V = p.c;
         U += p.d;
+        spike_offset_ms = dt_ms;
+        return 1;
+    }
+
+    return 0;
+}
+
+bool resting_fixed_point(double I, double dt_ms, const IzhParams& p, double& V_rest, double& U_rest)
+{
+    // dv/dt = 0 with U = b*V: 0.04*V^2 + (5 - b)*V + 140 + I = 0.
+    // The lower root is the resting state; the upper one is the saddle.
+    const double lin = 5.0 - p.b;
+    const double disc = lin * lin - 4.0 * 0.04 * (140.0 + I);
+    if (!(disc > 0.0)) {
+        return false;
+    }
+    const double V = (-lin - std::sqrt(disc)) / (2.0 * 0.04);
+    if (V >= p.V_th) {
+        return false;
+    }
+    if (!(V > p.V_min)) {
+        // The V_min clamp hides the root. Below the saddle dv/dt < 0 at
+        // V_min, so the clamp holds V there and U relaxes to b*V_min. Only
+        // consistent Euler is accepted: its U update reads the clamped V,
+        // which makes (V_min, b*V_min) an exact fixed point of the step.
+        const double saddle = (-lin + std::sqrt(disc)) / (2.0 * 0.04);
+        if (!(p.V_min < saddle) || p.integrator != Integrator::Euler || !p.consistent_integration ||
+            !(std::abs(1.0 - p.a * dt_ms) < 1.0)) {
+            return false;
+        }
+        V_rest = p.V_min;
+        U_rest = p.b * p.V_min;
         return true;
     }
 
-    return false;
+    // Jacobian [[j, -1], [a*b, -a]] of the continuous system at the root.
+    const double j = 0.08 * V + 5.0;
+    const double trace = j - p.a;
+    const double det = p.a * (p.b - j);
+    if (trace >= 0.0 || det <= 0.0) {
+        return false;
+    }
+
+    // Every scheme keeps (V, b*V) fixed, but each has its own stability
+    // region. Jury criterion on the Jacobian of the scheme's actual step
+    // map, by central differences around the fixed point.
+    const double U = p.b * V;
+    const double eps_V = 1e-6 * (1.0 + std::abs(V));
+    const double eps_U = 1e-6 * (1.0 + std::abs(U));
+    double V_hi = V + eps_V, U_hi = U, V_lo = V - eps_V, U_lo = U;
+    free_step(V_hi, U_hi, I, dt_ms, p);
+    free_step(V_lo, U_lo, I, dt_ms, p);
+    const double m_VV = (V_hi - V_lo) / (2.0 * eps_V);
+    const double m_UV = (U_hi - U_lo) / (2.0 * eps_V);
+    V_hi = V, U_hi = U + eps_U, V_lo = V, U_lo = U - eps_U;
+    free_step(V_hi, U_hi, I, dt_ms, p);
+    free_step(V_lo, U_lo, I, dt_ms, p);
+    const double m_VU = (V_hi - V_lo) / (2.0 * eps_U);
+    const double m_UU = (U_hi - U_lo) / (2.0 * eps_U);
+    const double map_trace = m_VV + m_UU;
+    const double map_det = m_VV * m_UU - m_VU * m_UV;
+    if (!(std::abs(map_det) < 1.0) || !(std::abs(map_trace) < 1.0 + map_det)) {
+        return false;
+    }
+
+    V_rest = V;
+    U_rest = U;
+    return true;
 }
 
 }
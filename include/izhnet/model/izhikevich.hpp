@@ -5,5 +5,18 @@ namespace izhnet {
 
 bool step_izhikevich(double& V, double& U, double I, double dt_ms, const IzhParams& p);
 
+// As above, but returns the number of threshold crossings in the step: at
+// most 1 for Euler, possibly more for the interpolating schemes at large
+// dt (capped at 16). spike_offset_ms receives the time of the first one
+// within the step; Euler reports dt_ms.
+int step_izhikevich(double& V, double& U, double I, double dt_ms, const IzhParams& p, double& spike_offset_ms);
+
+// Resting fixed point (V*, U*) for a constant input I. Returns false when no
+// fixed point exists, it lies at or above V_th, or it is not stable under
+// the step map of p's integration scheme at the given dt. When the
+// root lies below V_min, the clamped point (V_min, b*V_min) is returned for
+// consistent Euler if V_min is below the saddle.
+bool resting_fixed_point(double I, double dt_ms, const IzhParams& p, double& V_rest, double& U_rest);
+
 }
 
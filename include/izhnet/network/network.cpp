@@ -1,6 +1,9 @@
 #include "izhnet/network/network.hpp"
 
+#include "izhnet/core/rng.hpp"
+
 #include <algorithm>
+#include <bit>
 #include <numeric>
 #include <random>
 #include <stdexcept>
@@ -49,18 +52,37 @@ void Network::add_edge(std::uint32_t source, std::uint32_t target, double weight
 void Network::finalize()
 {
     offsets_.assign(static_cast<std::size_t>(neuron_count_) + 1U, 0U);
+    AlignedVector<std::uint32_t> in_offsets(static_cast<std::size_t>(neuron_count_) + 1U, 0U);
     for (const Edge& edge : edges_) {
         if (edge.source >= neuron_count_ || edge.target >= neuron_count_) {
             throw std::out_of_range("edge endpoint out of range");
         }
         ++offsets_[static_cast<std::size_t>(edge.source) + 1U];
+        ++in_offsets[static_cast<std::size_t>(edge.target) + 1U];
     }
     std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+    std::partial_sum(in_offsets.begin(), in_offsets.end(), in_offsets.begin());
 
     targets_.assign(edges_.size(), 0U);
     weights_.assign(edges_.size(), 0.0);
 
-    std::vector<std::uint32_t> cursor = offsets_;
+    // Two stable counting passes keep every row sorted by target, with
+    // parallel edges in insertion order. The first groups the edges by
+    // target, using the output arrays as scratch (targets_ holds the
+    // sources), and writes them back to edges_ in that order.
+    AlignedVector<std::uint32_t> cursor = in_offsets;
+    for (const Edge& edge : edges_) {
+        const std::size_t idx = cursor[edge.target]++;
+        targets_[idx] = edge.source;
+        weights_[idx] = edge.weight;
+    }
+    for (std::uint32_t target = 0; target < neuron_count_; ++target) {
+        for (std::size_t idx = in_offsets[target]; idx < in_offsets[target + 1U]; ++idx) {
+            edges_[idx] = Edge { targets_[idx], target, weights_[idx] };
+        }
+    }
+
+    cursor = offsets_;
     for (const Edge& edge : edges_) {
         const std::size_t idx = cursor[edge.source]++;
         targets_[idx] = edge.target;
@@ -82,21 +104,47 @@ std::size_t Network::edge_count() const
     return finalized_ ? targets_.size() : edges_.size();
 }
 
-const std::vector<std::uint32_t>& Network::offsets() const
+const AlignedVector<std::uint32_t>& Network::offsets() const
 {
     return offsets_;
 }
 
-const std::vector<std::uint32_t>& Network::targets() const
+const AlignedVector<std::uint32_t>& Network::targets() const
 {
     return targets_;
 }
 
-const std::vector<double>& Network::weights() const
+const AlignedVector<double>& Network::weights() const
 {
     return weights_;
 }
 
+std::uint64_t Network::fingerprint() const
+{
+    if (!finalized_) {
+        throw std::logic_error("fingerprint requires a finalized network");
+    }
+    std::uint64_t hash = splitmix64(neuron_count_ ^ (static_cast<std::uint64_t>(targets_.size()) << 32U));
+    for (const std::uint32_t offset : offsets_) {
+        hash = splitmix64(hash ^ offset);
+    }
+    for (std::size_t i = 0; i < targets_.size(); ++i) {
+        hash = splitmix64(hash ^ targets_[i]);
+        hash = splitmix64(hash ^ std::bit_cast<std::uint64_t>(weights_[i]));
+    }
+    return hash;
+}
+
+MemoryReport Network::memory_report() const
+{
+    MemoryReport report;
+    report.add("network.edges", capacity_bytes(edges_));
+    report.add("network.offsets", capacity_bytes(offsets_));
+    report.add("network.targets", capacity_bytes(targets_));
+    report.add("network.weights", capacity_bytes(weights_));
+    return report;
+}
+
 Network Network::random_fixed_out_degree(
     std::uint32_t neuron_count,
     std::uint32_t out_degree,
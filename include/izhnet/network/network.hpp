@@ -1,5 +1,7 @@
 #pragma once
 
+#include "izhnet/core/memory.hpp"
+
 #include <cstddef>
 #include <cstdint>
 #include <vector>
@@ -22,14 +24,24 @@ public:
     void clear_edges();
     void reserve_edges(std::size_t edge_count);
     void add_edge(std::uint32_t source, std::uint32_t target, double weight);
+    // Builds the CSR arrays. Each row is ordered by target, with parallel
+    // edges kept in insertion order, so a target range of a row can be
+    // found by binary search.
     void finalize();
 
     bool is_finalized() const;
     std::size_t edge_count() const;
 
-    const std::vector<std::uint32_t>& offsets() const;
-    const std::vector<std::uint32_t>& targets() const;
-    const std::vector<double>& weights() const;
+    const AlignedVector<std::uint32_t>& offsets() const;
+    const AlignedVector<std::uint32_t>& targets() const;
+    const AlignedVector<double>& weights() const;
+
+    // Hash of the finalized CSR arrays (offsets, targets, weight bits), so a
+    // checkpoint can tell whether it is resumed on the network it was taken
+    // on. One pass over the edges.
+    std::uint64_t fingerprint() const;
+
+    MemoryReport memory_report() const;
 
     static Network random_fixed_out_degree(
         std::uint32_t neuron_count,
@@ -43,9 +55,9 @@ private:
     std::uint32_t neuron_count_{ 0 };
     bool finalized_{ false };
     std::vector<Edge> edges_;
-    std::vector<std::uint32_t> offsets_;
-    std::vector<std::uint32_t> targets_;
-    std::vector<double> weights_;
+    AlignedVector<std::uint32_t> offsets_;
+    AlignedVector<std::uint32_t> targets_;
+    AlignedVector<double> weights_;
 };
 
 } // namespace izhnet
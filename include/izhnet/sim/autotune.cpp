@@ -0,0 +1,331 @@
+#include "izhnet/sim/autotune.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define IZHNET_HAS_FLOCK 1
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#else
+#define IZHNET_HAS_FLOCK 0
+#endif
+
+namespace izhnet {
+
+namespace {
+
+constexpr std::uint32_t kChunkCandidates[] = { 256U, 4096U };
+
+// Exclusive advisory lock on "<cache>.lock", held across the read-merge-
+// write of store_cached_plan so concurrent runs cannot drop each other's
+// entries. A no-op where flock is unavailable.
+class CacheLock {
+public:
+    explicit CacheLock(const std::string& cache_path)
+    {
+#if IZHNET_HAS_FLOCK
+        const std::string lock_path = cache_path + ".lock";
+        fd_ = ::open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("failed to open autotune cache lock: " + lock_path);
+        }
+        while (::flock(fd_, LOCK_EX) != 0) {
+            if (errno != EINTR) {
+                ::close(fd_);
+                throw std::runtime_error("failed to lock autotune cache: " + lock_path);
+            }
+        }
+#else
+        (void)cache_path;
+#endif
+    }
+
+    ~CacheLock()
+    {
+#if IZHNET_HAS_FLOCK
+        ::close(fd_); // releases the lock
+#endif
+    }
+
+    CacheLock(const CacheLock&) = delete;
+    CacheLock& operator=(const CacheLock&) = delete;
+
+private:
+    int fd_ = -1;
+};
+
+// Writes contents to a new, uniquely named file beside path and returns its
+// name, so no two writers ever share a staging file.
+std::string write_staging_file(const std::filesystem::path& path, const std::string& contents)
+{
+#if IZHNET_HAS_FLOCK
+    std::string staging = path.string() + ".XXXXXX";
+    const int fd = ::mkstemp(staging.data());
+    if (fd < 0) {
+        throw std::runtime_error("failed to create autotune cache staging file beside: " + path.string());
+    }
+    std::size_t written = 0;
+    while (written < contents.size()) {
+        const ssize_t n = ::write(fd, contents.data() + written, contents.size() - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            ::close(fd);
+            ::unlink(staging.c_str());
+            throw std::runtime_error("failed while writing autotune cache: " + staging);
+        }
+        written += static_cast<std::size_t>(n);
+    }
+    if (::close(fd) != 0) {
+        ::unlink(staging.c_str());
+        throw std::runtime_error("failed while writing autotune cache: " + staging);
+    }
+    return staging;
+#else
+    std::random_device entropy;
+    const std::string staging = path.string() + "." + std::to_string(entropy()) + std::to_string(entropy()) + ".tmp";
+    std::ofstream out(staging, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("failed to open autotune cache for writing: " + staging);
+    }
+    out << contents;
+    out.flush();
+    if (!out.good()) {
+        throw std::runtime_error("failed while writing autotune cache: " + staging);
+    }
+    return staging;
+#endif
+}
+
+std::vector<int> thread_candidates(int max_threads)
+{
+    std::vector<int> counts;
+    for (int threads = 2; threads < max_threads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    if (max_threads > 1) {
+        counts.push_back(max_threads);
+    }
+    return counts;
+}
+
+double median(std::vector<double>& samples)
+{
+    const auto middle = samples.begin() + static_cast<std::ptrdiff_t>(samples.size() / 2U);
+    std::nth_element(samples.begin(), middle, samples.end());
+    return *middle;
+}
+
+std::string cpu_model()
+{
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            const std::size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                const std::size_t first = line.find_first_not_of(' ', colon + 1U);
+                return (first == std::string::npos) ? std::string() : line.substr(first);
+            }
+        }
+    }
+    return "unknown";
+}
+
+unsigned floor_log2(std::size_t value)
+{
+    return (value == 0) ? 0U : static_cast<unsigned>(std::bit_width(value) - 1U);
+}
+
+} // namespace
+
+Autotuner::Autotuner(const AutotuneShape& shape, std::uint32_t steps_per_candidate)
+    : shape_(shape)
+    , steps_per_candidate_(steps_per_candidate)
+{
+    if (steps_per_candidate_ == 0) {
+        throw std::invalid_argument("autotune steps_per_candidate must be > 0");
+    }
+    begin_round();
+}
+
+const ExecutionPlan& Autotuner::plan() const
+{
+    return done() ? best_ : candidates_[candidate_];
+}
+
+void Autotuner::record_step(double seconds)
+{
+    if (done()) {
+        return;
+    }
+    // The first step of a candidate pays for spinning up its thread team.
+    if (warmup_left_ > 0) {
+        --warmup_left_;
+        return;
+    }
+    samples_.push_back(seconds);
+    if (samples_.size() < steps_per_candidate_) {
+        return;
+    }
+    scores_.push_back(median(samples_));
+    samples_.clear();
+    warmup_left_ = 1;
+    if (++candidate_ == candidates_.size()) {
+        finish_round();
+    }
+}
+
+// Fills candidates_ for the current round, moving on past rounds that have
+// nothing to choose between. The incumbent is always candidate 0.
+void Autotuner::begin_round()
+{
+    for (;;) {
+        candidates_.assign(1, best_);
+        switch (round_) {
+        case Round::Threads:
+            if (shape_.parallel_update) {
+                for (const int threads : thread_candidates(shape_.max_threads)) {
+                    ExecutionPlan plan = best_;
+                    plan.update_threads = threads;
+                    candidates_.push_back(plan);
+                }
+            }
+            break;
+        case Round::Schedule:
+            if (best_.update_threads > 0) {
+                for (const std::uint32_t chunk : kChunkCandidates) {
+                    if (chunk * static_cast<std::size_t>(best_.update_threads) < shape_.neuron_count) {
+                        ExecutionPlan plan = best_;
+                        plan.chunk = chunk;
+                        candidates_.push_back(plan);
+                    }
+                }
+            }
+            break;
+        case Round::Propagation:
+            for (const int threads : thread_candidates(shape_.max_threads)) {
+                ExecutionPlan plan = best_;
+                plan.propagation_threads = threads;
+                candidates_.push_back(plan);
+            }
+            break;
+        case Round::Done:
+            candidates_.clear();
+            return;
+        }
+
+        if (candidates_.size() > 1U) {
+            scores_.clear();
+            samples_.clear();
+            candidate_ = 0;
+            warmup_left_ = 1;
+            return;
+        }
+        round_ = static_cast<Round>(static_cast<std::uint8_t>(round_) + 1U);
+    }
+}
+
+void Autotuner::finish_round()
+{
+    const auto fastest = std::min_element(scores_.begin(), scores_.end());
+    best_ = candidates_[static_cast<std::size_t>(fastest - scores_.begin())];
+    round_ = static_cast<Round>(static_cast<std::uint8_t>(round_) + 1U);
+    begin_round();
+}
+
+std::string autotune_cache_key(const AutotuneShape& shape)
+{
+    const std::size_t degree = (shape.neuron_count > 0) ? shape.edge_count / shape.neuron_count : 0U;
+    std::ostringstream key;
+    key << "cpu=" << cpu_model()
+        << ";cpus=" << std::thread::hardware_concurrency()
+        << ";omp=" << shape.max_threads
+        << ";n=2^" << floor_log2(shape.neuron_count)
+        << ";deg=2^" << floor_log2(degree)
+        << ";par=" << (shape.parallel_update ? 1 : 0)
+        << ";skip=" << (shape.skip_quiescent ? 1 : 0)
+        << ";int=" << static_cast<unsigned>(shape.integrator);
+    std::string text = key.str();
+    std::replace_if(text.begin(), text.end(), [](char c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+    return text;
+}
+
+std::string default_autotune_cache_path()
+{
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg != nullptr && *xdg != '\0') {
+        return (std::filesystem::path(xdg) / "izhnet" / "autotune.tsv").string();
+    }
+    if (const char* home = std::getenv("HOME"); home != nullptr && *home != '\0') {
+        return (std::filesystem::path(home) / ".cache" / "izhnet" / "autotune.tsv").string();
+    }
+    return std::string();
+}
+
+bool load_cached_plan(const std::string& cache_path, const std::string& key, ExecutionPlan& plan)
+{
+    std::ifstream in(cache_path);
+    std::string line;
+    while (std::getline(in, line)) {
+        const std::size_t tab = line.find('\t');
+        if (tab == std::string::npos || line.compare(0, tab, key) != 0 || tab != key.size()) {
+            continue;
+        }
+        std::istringstream fields(line.substr(tab + 1U));
+        ExecutionPlan cached;
+        if (fields >> cached.update_threads >> cached.chunk >> cached.propagation_threads &&
+            cached.update_threads >= 0 && cached.propagation_threads >= 0) {
+            plan = cached;
+            return true;
+        }
+    }
+    return false;
+}
+
+void store_cached_plan(const std::string& cache_path, const std::string& key, const ExecutionPlan& plan)
+{
+    const std::filesystem::path path(cache_path);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+    const CacheLock lock(cache_path);
+
+    std::string contents;
+    {
+        std::ifstream in(cache_path);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.compare(0, key.size() + 1U, key + '\t') != 0) {
+                contents += line;
+                contents += '\n';
+            }
+        }
+    }
+    std::ostringstream entry;
+    entry << key << '\t' << plan.update_threads << '\t' << plan.chunk << '\t' << plan.propagation_threads << '\n';
+    contents += entry.str();
+
+    // Renamed over the cache, so readers, which take no lock, never see a
+    // half-written file.
+    const std::string staging = write_staging_file(path, contents);
+    std::error_code error;
+    std::filesystem::rename(staging, path, error);
+    if (error) {
+        std::filesystem::remove(staging, error);
+        throw std::runtime_error("failed to replace autotune cache: " + cache_path);
+    }
+}
+
+} // namespace izhnet
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace izhnet {
+
+// How the step loop runs. Every plan produces bit-identical results; they
+// differ only in speed. Parallel propagation splits the targets into
+// ranges of roughly equal in-degree, one per thread.
+struct ExecutionPlan {
+    int update_threads = 0;      // 0: serial neuron update
+    std::uint32_t chunk = 0;     // 0: schedule(static); otherwise dynamic chunks of this size
+    int propagation_threads = 0; // 0: serial spike propagation
+};
+
+struct AutotuneConfig {
+    bool enabled = false;
+    std::uint32_t steps_per_candidate = 8; // timed steps per candidate, after one warm-up step
+    std::string cache_path;                // empty: do not read or write a cache
+};
+
+// Problem shape the best plan depends on; becomes part of the cache key.
+struct AutotuneShape {
+    std::size_t neuron_count = 0;
+    std::size_t edge_count = 0;
+    int max_threads = 1;
+    bool parallel_update = true; // false when noise forces the serial update
+    bool skip_quiescent = false;
+    std::uint8_t integrator = 0;
+};
+
+// Picks a plan by coordinate search over the first steps of the actual run:
+// thread count first, then the update schedule, then the propagation
+// kernel. The incumbent is re-timed in every round so rounds that land in
+// different activity phases stay comparable. Candidates are scored by the
+// median step time.
+class Autotuner {
+public:
+    Autotuner(const AutotuneShape& shape, std::uint32_t steps_per_candidate);
+
+    bool done() const { return round_ == Round::Done; }
+
+    // Plan for the next step: the candidate under test, or the winner.
+    const ExecutionPlan& plan() const;
+
+    void record_step(double seconds);
+
+private:
+    enum class Round : std::uint8_t { Threads, Schedule, Propagation, Done };
+
+    void begin_round();
+    void finish_round();
+
+    AutotuneShape shape_;
+    std::uint32_t steps_per_candidate_;
+    Round round_ = Round::Threads;
+    std::vector<ExecutionPlan> candidates_;
+    std::vector<double> scores_;
+    std::vector<double> samples_;
+    std::size_t candidate_ = 0;
+    std::uint32_t warmup_left_ = 1;
+    ExecutionPlan best_ {};
+};
+
+// "cpu=<model>;cpus=<n>;omp=<n>;n=2^a;deg=2^b;..." with tabs and newlines removed.
+std::string autotune_cache_key(const AutotuneShape& shape);
+
+// $XDG_CACHE_HOME/izhnet/autotune.tsv, falling back to ~/.cache; empty if
+// neither is set.
+std::string default_autotune_cache_path();
+
+// Cache lines are "key<TAB>update_threads<TAB>chunk<TAB>propagation_threads".
+// Stores hold a lock on "<cache_path>.lock" and replace the file by rename,
+// so concurrent runs keep each other's entries.
+bool load_cached_plan(const std::string& cache_path, const std::string& key, ExecutionPlan& plan);
+void store_cached_plan(const std::string& cache_path, const std::string& key, const ExecutionPlan& plan);
+
+} // namespace izhnet
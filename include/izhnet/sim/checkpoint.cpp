@@ -0,0 +1,258 @@
+#include "izhnet/sim/checkpoint.hpp"
+
+#include "izhnet/core/binary_io.hpp"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace izhnet {
+
+namespace {
+
+constexpr std::array<char, 8> kCheckpointMagic { 'I', 'Z', 'C', 'K', 'P', 'T', '0', '1' };
+constexpr std::uint32_t kCheckpointVersion = 2;
+
+template <class T>
+void read_field(std::ifstream& in, T& value, const std::string& path)
+{
+    if (!read_pod(in, value)) {
+        throw std::runtime_error("truncated checkpoint: " + path);
+    }
+}
+
+template <class Vector>
+void write_array(std::ofstream& out, const Vector& values)
+{
+    write_pod(out, static_cast<std::uint64_t>(values.size()));
+    out.write(reinterpret_cast<const char*>(values.data()),
+        static_cast<std::streamsize>(values.size() * sizeof(typename Vector::value_type)));
+}
+
+// Lengths are checked against the bytes left in the file before resizing,
+// so a corrupt length cannot trigger a huge allocation.
+template <class Vector>
+void read_array(std::ifstream& in, Vector& values, std::uint64_t remaining, const std::string& path)
+{
+    std::uint64_t count = 0;
+    read_field(in, count, path);
+    if (count > remaining / sizeof(typename Vector::value_type)) {
+        throw std::runtime_error("corrupt checkpoint array length: " + path);
+    }
+    values.resize(static_cast<std::size_t>(count));
+    in.read(reinterpret_cast<char*>(values.data()),
+        static_cast<std::streamsize>(count * sizeof(typename Vector::value_type)));
+    if (!in) {
+        throw std::runtime_error("truncated checkpoint: " + path);
+    }
+}
+
+} // namespace
+
+void write_checkpoint(const std::string& output_path, const SimulationCheckpoint& checkpoint)
+{
+    const std::filesystem::path path(output_path);
+    if (path.has_parent_path()) {
+        std::filesystem::create_directories(path.parent_path());
+    }
+    const std::filesystem::path staging = path.string() + ".tmp";
+    {
+        std::ofstream out(staging, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            throw std::runtime_error("failed to open checkpoint for writing: " + staging.string());
+        }
+
+        out.write(kCheckpointMagic.data(), static_cast<std::streamsize>(kCheckpointMagic.size()));
+        write_pod(out, kCheckpointVersion);
+        write_pod(out, static_cast<std::uint32_t>(checkpoint.state.size()));
+        write_pod(out, checkpoint.step);
+        write_pod(out, std::uint32_t { 0U });
+        write_pod(out, checkpoint.seed);
+        write_pod(out, checkpoint.dt_ms);
+        write_pod(out, checkpoint.network_edges);
+        write_pod(out, checkpoint.network_fingerprint);
+
+        write_array(out, checkpoint.state.V);
+        write_array(out, checkpoint.state.U);
+        write_array(out, checkpoint.state.I);
+        write_array(out, checkpoint.state.spiked);
+        write_array(out, checkpoint.syn_current);
+        write_array(out, checkpoint.awake);
+        write_array(out, checkpoint.rest_signature);
+        write_array(out, checkpoint.noise_rng);
+
+        const ExternalInputState& input = checkpoint.input;
+        write_array(out, input.rng);
+        write_array(out, input.next_cells);
+        write_pod(out, static_cast<std::uint64_t>(input.heaps.size()));
+        for (const auto& heap : input.heaps) {
+            write_pod(out, static_cast<std::uint64_t>(heap.size()));
+            for (const auto& [step, neuron] : heap) {
+                write_pod(out, step);
+                write_pod(out, neuron);
+            }
+        }
+        write_array(out, input.train_positions);
+
+        out.flush();
+        if (!out.good()) {
+            throw std::runtime_error("failed while writing checkpoint: " + staging.string());
+        }
+    }
+    std::filesystem::rename(staging, path);
+}
+
+SimulationCheckpoint read_checkpoint(const std::string& input_path)
+{
+    std::ifstream in(input_path, std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+        throw std::runtime_error("failed to open checkpoint: " + input_path);
+    }
+    const std::uint64_t file_bytes = std::filesystem::file_size(input_path);
+
+    std::array<char, 8> magic {};
+    in.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+    if (!in || magic != kCheckpointMagic) {
+        throw std::runtime_error("not an izhnet checkpoint: " + input_path);
+    }
+    std::uint32_t version = 0;
+    read_field(in, version, input_path);
+    if (version != kCheckpointVersion) {
+        throw std::runtime_error("unsupported checkpoint version: " + input_path);
+    }
+
+    SimulationCheckpoint checkpoint;
+    std::uint32_t neuron_count = 0;
+    std::uint32_t reserved = 0;
+    read_field(in, neuron_count, input_path);
+    read_field(in, checkpoint.step, input_path);
+    read_field(in, reserved, input_path);
+    read_field(in, checkpoint.seed, input_path);
+    read_field(in, checkpoint.dt_ms, input_path);
+    read_field(in, checkpoint.network_edges, input_path);
+    read_field(in, checkpoint.network_fingerprint, input_path);
+
+    read_array(in, checkpoint.state.V, file_bytes, input_path);
+    read_array(in, checkpoint.state.U, file_bytes, input_path);
+    read_array(in, checkpoint.state.I, file_bytes, input_path);
+    read_array(in, checkpoint.state.spiked, file_bytes, input_path);
+    read_array(in, checkpoint.syn_current, file_bytes, input_path);
+    read_array(in, checkpoint.awake, file_bytes, input_path);
+    read_array(in, checkpoint.rest_signature, file_bytes, input_path);
+    read_array(in, checkpoint.noise_rng, file_bytes, input_path);
+
+    const std::size_t n = neuron_count;
+    if (checkpoint.state.V.size() != n || checkpoint.state.U.size() != n || checkpoint.state.I.size() != n ||
+        checkpoint.state.spiked.size() != n || checkpoint.syn_current.size() != n ||
+        (!checkpoint.awake.empty() && checkpoint.awake.size() != n)) {
+        throw std::runtime_error("checkpoint arrays do not match its neuron count: " + input_path);
+    }
+
+    ExternalInputState& input = checkpoint.input;
+    read_array(in, input.rng, file_bytes, input_path);
+    read_array(in, input.next_cells, file_bytes, input_path);
+    std::uint64_t heap_count = 0;
+    read_field(in, heap_count, input_path);
+    if (heap_count > file_bytes / sizeof(std::uint64_t)) {
+        throw std::runtime_error("corrupt checkpoint input state: " + input_path);
+    }
+    input.heaps.resize(static_cast<std::size_t>(heap_count));
+    for (auto& heap : input.heaps) {
+        std::uint64_t entries = 0;
+        read_field(in, entries, input_path);
+        if (entries > file_bytes / (sizeof(std::uint64_t) + sizeof(std::uint32_t))) {
+            throw std::runtime_error("corrupt checkpoint input state: " + input_path);
+        }
+        heap.resize(static_cast<std::size_t>(entries));
+        for (auto& [step, neuron] : heap) {
+            read_field(in, step, input_path);
+            read_field(in, neuron, input_path);
+        }
+    }
+    read_array(in, input.train_positions, file_bytes, input_path);
+    return checkpoint;
+}
+
+CheckpointWriter::CheckpointWriter(std::string output_path)
+    : output_path_(std::move(output_path))
+{
+    if (output_path_.empty()) {
+        throw std::invalid_argument("checkpoint output_path must be set");
+    }
+    writer_ = std::thread([this]() { writer_loop(); });
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    close_quietly(*this);
+}
+
+SimulationCheckpoint& CheckpointWriter::acquire()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return !pending_; });
+    if (writer_error_) {
+        std::rethrow_exception(writer_error_);
+    }
+    return buffer_;
+}
+
+void CheckpointWriter::submit()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = true;
+    }
+    cv_.notify_all();
+}
+
+void CheckpointWriter::close()
+{
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closing_ = true;
+    }
+    cv_.notify_all();
+    writer_.join();
+    if (writer_error_) {
+        std::rethrow_exception(writer_error_);
+    }
+}
+
+void CheckpointWriter::writer_loop()
+{
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return pending_ || closing_; });
+            if (!pending_) {
+                return;
+            }
+        }
+
+        // The loop does not touch buffer_ until pending_ is cleared.
+        bool written = false;
+        try {
+            write_checkpoint(output_path_, buffer_);
+            written = true;
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            writer_error_ = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_ = false;
+            written_ += written ? 1U : 0U;
+        }
+        cv_.notify_all();
+    }
+}
+
+} // namespace izhnet
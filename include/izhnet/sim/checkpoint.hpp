@@ -0,0 +1,88 @@
+#pragma once
+
+#include "izhnet/core/memory.hpp"
+#include "izhnet/core/types.hpp"
+#include "izhnet/sim/external_input.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace izhnet {
+
+struct CheckpointConfig {
+    std::uint32_t every_steps = 0; // 0 disables periodic checkpoints
+    std::string output_path;       // replaced atomically by every checkpoint
+    bool write_final = false;      // also write the state after the last step
+    bool keep_final = false;       // return the final state in SimulationResult
+};
+
+// Everything the step loop carries from one step to the next, taken at the
+// start of `step`: syn_current already holds the input of that step and the
+// generators are positioned after it.
+struct SimulationCheckpoint {
+    std::uint32_t step = 0;
+    std::uint64_t seed = 0;
+    double dt_ms = 0.0;
+    // Identifies the network the run was on; see Network::fingerprint().
+    std::uint64_t network_edges = 0;
+    std::uint64_t network_fingerprint = 0;
+    NetworkState state;
+    AlignedVector<double> syn_current;
+    std::string noise_rng; // engine and normal distribution, stream representation
+    ExternalInputState input;
+
+    // Active-set flags, and the settings their resting points were computed
+    // under; both empty unless skip_quiescent was on.
+    AlignedVector<std::uint8_t> awake;
+    std::vector<double> rest_signature;
+};
+
+// Layout (little-endian, native widths): "IZCKPT01", u32 version, u32
+// neuron_count, u32 step, u32 reserved, u64 seed, f64 dt_ms, u64
+// network_edges, u64 network_fingerprint, then V, U, I, spiked,
+// syn_current and awake arrays (u64 length each), the rest signature, the RNG strings and the input generator positions. Written to
+// a temporary file and renamed, so a crash leaves the previous checkpoint.
+void write_checkpoint(const std::string& output_path, const SimulationCheckpoint& checkpoint);
+SimulationCheckpoint read_checkpoint(const std::string& input_path);
+
+// Writes checkpoints on a background thread. The loop copies its state into
+// the buffer from acquire() and calls submit(); it only waits if the
+// previous checkpoint is still being written.
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(std::string output_path);
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&) = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    SimulationCheckpoint& acquire();
+    void submit();
+
+    // Waits for the pending write and rethrows a writer error.
+    void close();
+
+    std::uint64_t checkpoints_written() const { return written_; }
+
+private:
+    void writer_loop();
+
+    std::string output_path_;
+    SimulationCheckpoint buffer_;
+    bool pending_ = false;
+    bool closing_ = false;
+    bool closed_ = false;
+    std::uint64_t written_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::exception_ptr writer_error_;
+    std::thread writer_;
+};
+
+} // namespace izhnet
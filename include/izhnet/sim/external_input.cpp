@@ -0,0 +1,234 @@
+#include "izhnet/sim/external_input.hpp"
+
+#include "izhnet/io/spike_archive.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace izhnet {
+
+namespace {
+
+bool has_suffix(const std::string& text, const std::string& suffix)
+{
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::uint32_t step_for_time(double time_ms, double dt_ms)
+{
+    const double step = std::nearbyint(time_ms / dt_ms);
+    if (!(step >= 0.0) || step > static_cast<double>(UINT32_MAX)) {
+        throw std::out_of_range("spike train time outside the representable step range");
+    }
+    return static_cast<std::uint32_t>(step);
+}
+
+} // namespace
+
+SpikeTrainInput load_spike_train(const std::string& input_path, double dt_ms, double weight)
+{
+    if (dt_ms <= 0.0) {
+        throw std::invalid_argument("dt_ms must be > 0");
+    }
+
+    SpikeTrainInput train;
+    train.weight = weight;
+
+    if (has_suffix(input_path, ".izsa")) {
+        const SpikeArchive archive(input_path);
+        const double archive_dt = archive.info().dt_ms;
+        const auto records = archive.steps(0, archive.info().step_count);
+        const auto offsets = archive.offsets_ms(records);
+        train.events.reserve(records.size());
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            const SpikeEvent& event = records[i];
+            const double time_ms = event.step * archive_dt + (offsets.empty() ? 0.0 : offsets[i]);
+            train.events.push_back(SpikeEvent { event.neuron_id, step_for_time(time_ms, dt_ms) });
+        }
+        return train;
+    }
+
+    std::ifstream in(input_path);
+    if (!in.is_open()) {
+        throw std::runtime_error("failed to open spike train: " + input_path);
+    }
+    std::string line;
+    std::size_t line_number = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        if (line.empty() || (line_number == 1 && line.compare(0, 7, "time_ms") == 0)) {
+            continue;
+        }
+        const char* first = line.data();
+        const char* last = line.data() + line.size();
+        double time_ms = 0.0;
+        std::uint32_t neuron_id = 0;
+        auto parsed = std::from_chars(first, last, time_ms);
+        if (parsed.ec == std::errc() && parsed.ptr != last && *parsed.ptr == ',') {
+            parsed = std::from_chars(parsed.ptr + 1, last, neuron_id);
+        } else {
+            parsed.ec = std::errc::invalid_argument;
+        }
+        if (parsed.ec != std::errc()) {
+            throw std::runtime_error(
+                "malformed spike train line " + std::to_string(line_number) + ": " + input_path);
+        }
+        train.events.push_back(SpikeEvent { neuron_id, step_for_time(time_ms, dt_ms) });
+    }
+    return train;
+}
+
+ExternalInput::ExternalInput(
+    const std::vector<PoissonInput>& poisson_inputs,
+    const std::vector<SpikeTrainInput>& spike_trains,
+    std::uint32_t network_size,
+    double dt_ms,
+    std::uint64_t seed,
+    std::uint32_t first_step)
+    : rng_(seed)
+{
+    const double dt_s = dt_ms * 1e-3;
+    for (const PoissonInput& input : poisson_inputs) {
+        if (static_cast<std::uint64_t>(input.first_neuron) + input.neuron_count > network_size) {
+            throw std::out_of_range("poisson input targets neurons outside the network");
+        }
+        if (!input.rates_hz.empty() && input.rates_hz.size() != input.neuron_count) {
+            throw std::invalid_argument("poisson rates_hz must have one entry per target neuron");
+        }
+        if (!input.weights.empty() && input.weights.size() != input.neuron_count) {
+            throw std::invalid_argument("poisson weights must have one entry per target neuron");
+        }
+        if (input.rates_hz.empty() && !(input.rate_hz >= 0.0)) {
+            throw std::invalid_argument("poisson rate_hz must be >= 0");
+        }
+
+        if (input.rates_hz.empty()) {
+            if (input.neuron_count == 0 || input.rate_hz == 0.0) {
+                continue;
+            }
+            UniformSource source;
+            source.first_neuron = input.first_neuron;
+            source.neuron_count = input.neuron_count;
+            source.lambda = input.rate_hz * dt_s;
+            source.weight = input.weight;
+            source.weights = input.weights;
+            const std::uint64_t skip = geometric_skip(rng_, -source.lambda);
+            const std::uint64_t first_cell = static_cast<std::uint64_t>(first_step) * source.neuron_count;
+            source.next_cell = (skip < UINT64_MAX - first_cell) ? first_cell + skip : UINT64_MAX;
+            uniform_.push_back(std::move(source));
+            continue;
+        }
+
+        HeterogeneousSource source;
+        source.first_neuron = input.first_neuron;
+        source.weight = input.weight;
+        source.weights = input.weights;
+        source.lambda.resize(input.neuron_count);
+        for (std::uint32_t local = 0; local < input.neuron_count; ++local) {
+            const double rate = input.rates_hz[local];
+            if (!(rate >= 0.0)) {
+                throw std::invalid_argument("poisson rates_hz must be >= 0");
+            }
+            source.lambda[local] = rate * dt_s;
+            if (rate > 0.0) {
+                const std::uint64_t skip = geometric_skip(rng_, -source.lambda[local]);
+                source.heap.emplace_back((skip < UINT64_MAX - first_step) ? first_step + skip : UINT64_MAX, local);
+            }
+        }
+        std::make_heap(source.heap.begin(), source.heap.end(), std::greater<>());
+        heterogeneous_.push_back(std::move(source));
+    }
+
+    for (const SpikeTrainInput& train : spike_trains) {
+        TrainCursor cursor;
+        cursor.events = train.events;
+        cursor.weight = train.weight;
+        for (const SpikeEvent& event : cursor.events) {
+            if (event.neuron_id >= network_size) {
+                throw std::out_of_range("spike train targets a neuron outside the network");
+            }
+        }
+        std::stable_sort(cursor.events.begin(), cursor.events.end(),
+            [](const SpikeEvent& lhs, const SpikeEvent& rhs) { return lhs.step < rhs.step; });
+        cursor.next = static_cast<std::size_t>(std::partition_point(cursor.events.begin(), cursor.events.end(),
+            [first_step](const SpikeEvent& event) { return event.step < first_step; }) - cursor.events.begin());
+        trains_.push_back(std::move(cursor));
+    }
+}
+
+ExternalInputState ExternalInput::snapshot() const
+{
+    ExternalInputState state;
+    std::ostringstream engine;
+    engine << rng_;
+    state.rng = engine.str();
+    for (const UniformSource& source : uniform_) {
+        state.next_cells.push_back(source.next_cell);
+    }
+    for (const HeterogeneousSource& source : heterogeneous_) {
+        state.heaps.push_back(source.heap);
+    }
+    for (const TrainCursor& train : trains_) {
+        state.train_positions.push_back(train.next);
+    }
+    return state;
+}
+
+bool ExternalInput::restore(const ExternalInputState& state)
+{
+    if (state.next_cells.size() != uniform_.size() || state.heaps.size() != heterogeneous_.size() ||
+        state.train_positions.size() != trains_.size()) {
+        return false;
+    }
+    for (std::size_t k = 0; k < heterogeneous_.size(); ++k) {
+        for (const auto& entry : state.heaps[k]) {
+            if (entry.second >= heterogeneous_[k].lambda.size()) {
+                return false;
+            }
+        }
+    }
+    for (std::size_t k = 0; k < trains_.size(); ++k) {
+        if (state.train_positions[k] > trains_[k].events.size()) {
+            return false;
+        }
+    }
+    std::mt19937_64 engine;
+    std::istringstream engine_text(state.rng);
+    if (!(engine_text >> engine)) {
+        return false;
+    }
+
+    rng_ = engine;
+    for (std::size_t k = 0; k < uniform_.size(); ++k) {
+        uniform_[k].next_cell = state.next_cells[k];
+    }
+    for (std::size_t k = 0; k < heterogeneous_.size(); ++k) {
+        heterogeneous_[k].heap = state.heaps[k];
+        std::make_heap(heterogeneous_[k].heap.begin(), heterogeneous_[k].heap.end(), std::greater<>());
+    }
+    for (std::size_t k = 0; k < trains_.size(); ++k) {
+        trains_[k].next = static_cast<std::size_t>(state.train_positions[k]);
+    }
+    return true;
+}
+
+// Events in a cell that is known to hold at least one: a zero-truncated
+// Poisson draw by inversion, almost always 1 at sub-millisecond steps.
+std::uint32_t ExternalInput::event_count(double lambda)
+{
+    const double u = uniform_open_closed(rng_) * -std::expm1(-lambda);
+    double term = lambda * std::exp(-lambda);
+    double cumulative = term;
+    std::uint32_t count = 1;
+    while (cumulative < u && term > 0.0) {
+        ++count;
+        term *= lambda / static_cast<double>(count);
+        cumulative += term;
+    }
+    return count;
+}
+
+} // namespace izhnet
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "izhnet/core/rng.hpp"
+#include "izhnet/core/types.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace izhnet {
+
+// Independent Poisson drive onto neurons [first_neuron, first_neuron +
+// neuron_count). Each event adds weight to the target's synaptic current
+// for one step. rates_hz / weights, when non-empty, hold one entry per
+// target neuron and override the population-wide value.
+struct PoissonInput {
+    std::uint32_t first_neuron = 0;
+    std::uint32_t neuron_count = 0;
+    double rate_hz = 0.0;
+    double weight = 0.0;
+    std::vector<double> rates_hz;
+    std::vector<double> weights;
+};
+
+// Recorded spikes replayed as input: neuron_id is the target and step the
+// delivery step. Events need not be sorted.
+struct SpikeTrainInput {
+    std::vector<SpikeEvent> events;
+    double weight = 0.0;
+};
+
+// Reads a spike CSV (time_ms,neuron_id[,...]) or a .izsa spike archive and
+// maps every spike to the step nearest its time under dt_ms.
+SpikeTrainInput load_spike_train(const std::string& input_path, double dt_ms, double weight);
+
+// Generator position, enough to continue the event streams exactly.
+struct ExternalInputState {
+    std::string rng; // engine state in its stream representation
+    std::vector<std::uint64_t> next_cells;
+    std::vector<std::vector<std::pair<std::uint64_t, std::uint32_t>>> heaps;
+    std::vector<std::uint64_t> train_positions;
+};
+
+// Event generator for all configured inputs. Poisson events are drawn with
+// geometric skips between hits, so the cost per step scales with the
+// number of events delivered rather than with the number of driven
+// neurons. Steps must be requested consecutively, starting at first_step.
+class ExternalInput {
+public:
+    ExternalInput(
+        const std::vector<PoissonInput>& poisson_inputs,
+        const std::vector<SpikeTrainInput>& spike_trains,
+        std::uint32_t network_size,
+        double dt_ms,
+        std::uint64_t seed,
+        std::uint32_t first_step = 0);
+
+    bool empty() const { return uniform_.empty() && heterogeneous_.empty() && trains_.empty(); }
+    std::uint64_t events_delivered() const { return events_delivered_; }
+
+    ExternalInputState snapshot() const;
+
+    // Continues from a snapshot taken with the same inputs. Returns false,
+    // leaving the generator untouched, if the snapshot does not fit them.
+    bool restore(const ExternalInputState& state);
+
+    // Calls deliver(target, current) for every input event of the step.
+    template <class Deliver>
+    void deliver(std::uint32_t step, Deliver&& deliver);
+
+private:
+    // Population with a shared rate: one Bernoulli trial per (step, neuron)
+    // cell, laid out step-major, and next_cell is the next hit.
+    struct UniformSource {
+        std::uint32_t first_neuron = 0;
+        std::uint32_t neuron_count = 0;
+        double lambda = 0.0; // expected events per neuron and step; P(no event) = exp(-lambda)
+        double weight = 0.0;
+        std::vector<double> weights;
+        std::uint64_t next_cell = 0;
+    };
+
+    // Per-neuron rates: each neuron keeps its own next hit step, and a
+    // min-heap orders them.
+    struct HeterogeneousSource {
+        std::uint32_t first_neuron = 0;
+        std::vector<double> lambda;
+        double weight = 0.0;
+        std::vector<double> weights;
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> heap; // (step, local neuron)
+    };
+
+    struct TrainCursor {
+        std::vector<SpikeEvent> events; // sorted by step, then neuron
+        double weight = 0.0;
+        std::size_t next = 0;
+    };
+
+    std::uint32_t event_count(double lambda);
+
+    std::vector<UniformSource> uniform_;
+    std::vector<HeterogeneousSource> heterogeneous_;
+    std::vector<TrainCursor> trains_;
+    std::mt19937_64 rng_;
+    std::uint64_t events_delivered_ = 0;
+};
+
+template <class Deliver>
+void ExternalInput::deliver(std::uint32_t step, Deliver&& deliver)
+{
+    for (UniformSource& source : uniform_) {
+        const std::uint64_t step_begin = static_cast<std::uint64_t>(step) * source.neuron_count;
+        const std::uint64_t step_end = step_begin + source.neuron_count;
+        while (source.next_cell < step_end) {
+            const auto local = static_cast<std::uint32_t>(source.next_cell - step_begin);
+            const double weight = source.weights.empty() ? source.weight : source.weights[local];
+            const std::uint32_t count = event_count(source.lambda);
+            deliver(source.first_neuron + local, weight * static_cast<double>(count));
+            events_delivered_ += count;
+            const std::uint64_t skip = geometric_skip(rng_, -source.lambda);
+            source.next_cell = (skip < UINT64_MAX - source.next_cell) ? source.next_cell + 1U + skip : UINT64_MAX;
+        }
+    }
+
+    for (HeterogeneousSource& source : heterogeneous_) {
+        auto& heap = source.heap;
+        while (!heap.empty() && heap.front().first <= step) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+            const std::uint32_t local = heap.back().second;
+            const double weight = source.weights.empty() ? source.weight : source.weights[local];
+            const std::uint32_t count = event_count(source.lambda[local]);
+            deliver(source.first_neuron + local, weight * static_cast<double>(count));
+            events_delivered_ += count;
+            const std::uint64_t skip = geometric_skip(rng_, -source.lambda[local]);
+            if (skip < UINT64_MAX - step) {
+                heap.back().first = static_cast<std::uint64_t>(step) + 1U + skip;
+                std::push_heap(heap.begin(), heap.end(), std::greater<>());
+            } else {
+                heap.pop_back();
+            }
+        }
+    }
+
+    for (TrainCursor& train : trains_) {
+        while (train.next < train.events.size() && train.events[train.next].step < step) {
+            ++train.next;
+        }
+        while (train.next < train.events.size() && train.events[train.next].step == step) {
+            deliver(train.events[train.next].neuron_id, train.weight);
+            ++events_delivered_;
+            ++train.next;
+        }
+    }
+}
+
+} // namespace izhnet
@@ -1,13 +1,21 @@
 #include "izhnet/sim/simulator.hpp"
 
+#include "izhnet/core/rng.hpp"
+#include "izhnet/core/timer.hpp"
 #include "izhnet/model/izhikevich.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <limits>
+#include <memory>
+#include <numeric>
 #include <random>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 #include <utility>
 
 #if IZHNET_HAS_OPENMP
@@ -16,7 +24,140 @@
 
 namespace izhnet {
 
+namespace {
+
+constexpr std::uint64_t kExternalInputStream = 1;
+constexpr std::uint64_t kResumedNoiseStream = 2;
+
+// Settings the resting points of the active set depend on. Sleeping flags
+// from a checkpoint are only reused when these are unchanged.
+std::vector<double> rest_signature(const SimulationConfig& config)
+{
+    const IzhParams& p = config.neuron;
+    return {
+        config.tonic_current, config.quiescent_tolerance, config.sim.dt_ms,
+        p.V_th, p.V_min, p.a, p.b, p.c, p.d,
+        p.consistent_integration ? 1.0 : 0.0,
+        static_cast<double>(static_cast<std::uint8_t>(p.integrator))
+    };
+}
+
+SimulationResult run_simulation(
+    const Network& network,
+    NetworkState initial_state,
+    const SimulationConfig& config,
+    SimulationArena& arena,
+    const SimulationCheckpoint* resume);
+
+} // namespace
+
+void SimulationArena::prepare(
+    std::size_t neuron_count,
+    std::size_t thread_count,
+    std::size_t reserve_spike_events,
+    bool track_active,
+    bool track_offsets)
+{
+    syn_current.assign(neuron_count, 0.0);
+    next_syn_current.assign(neuron_count, 0.0);
+    step_spikes.clear();
+    step_spikes.reserve(neuron_count);
+
+    if (thread_spikes.size() < thread_count) {
+        thread_spikes.resize(thread_count);
+    }
+    if (thread_woken.size() < thread_count) {
+        thread_woken.resize(thread_count);
+    }
+    const std::size_t per_thread = (thread_count > 0) ? reserve_spike_events / thread_count : 0;
+    for (auto& local : thread_spikes) {
+        local.clear();
+        local.reserve(per_thread);
+    }
+
+    spike_offset_ms.resize(track_offsets ? neuron_count : 0U);
+
+    active.clear();
+    next_active.clear();
+    woken.clear();
+    if (track_active) {
+        rest_V.resize(neuron_count);
+        rest_U.resize(neuron_count);
+        awake.assign(neuron_count, 1U);
+        active.resize(neuron_count);
+        next_active.reserve(neuron_count);
+        if (thread_active.size() < thread_count) {
+            thread_active.resize(thread_count);
+        }
+    }
+}
+
+MemoryReport SimulationArena::memory_report() const
+{
+    MemoryReport report;
+    report.add("arena.syn_current", capacity_bytes(syn_current));
+    report.add("arena.next_syn_current", capacity_bytes(next_syn_current));
+    std::size_t thread_bytes = 0;
+    for (const auto& local : thread_spikes) {
+        thread_bytes += capacity_bytes(local);
+    }
+    report.add("arena.thread_spikes", thread_bytes);
+    report.add("arena.step_spikes", capacity_bytes(step_spikes));
+    report.add("arena.spike_offset_ms", capacity_bytes(spike_offset_ms));
+    report.add("arena.rest_V", capacity_bytes(rest_V));
+    report.add("arena.rest_U", capacity_bytes(rest_U));
+    report.add("arena.awake", capacity_bytes(awake));
+    std::size_t active_bytes = capacity_bytes(active) + capacity_bytes(next_active) + capacity_bytes(woken);
+    for (const auto& local : thread_active) {
+        active_bytes += capacity_bytes(local);
+    }
+    report.add("arena.active_set", active_bytes);
+    std::size_t partition_bytes = capacity_bytes(in_degree_prefix) + target_bounds.capacity() * sizeof(std::uint32_t);
+    for (const auto& local : thread_woken) {
+        partition_bytes += capacity_bytes(local);
+    }
+    report.add("arena.propagation_partition", partition_bytes);
+    return report;
+}
+
 SimulationResult simulate_network(const Network& network, NetworkState initial_state, const SimulationConfig& config)
+{
+    SimulationArena arena;
+    return simulate_network(network, std::move(initial_state), config, arena);
+}
+
+SimulationResult simulate_network(
+    const Network& network,
+    NetworkState initial_state,
+    const SimulationConfig& config,
+    SimulationArena& arena)
+{
+    return run_simulation(network, std::move(initial_state), config, arena, nullptr);
+}
+
+SimulationResult resume_simulation(const Network& network, const SimulationCheckpoint& checkpoint, const SimulationConfig& config)
+{
+    SimulationArena arena;
+    return resume_simulation(network, checkpoint, config, arena);
+}
+
+SimulationResult resume_simulation(
+    const Network& network,
+    const SimulationCheckpoint& checkpoint,
+    const SimulationConfig& config,
+    SimulationArena& arena)
+{
+    return run_simulation(network, checkpoint.state, config, arena, &checkpoint);
+}
+
+namespace {
+
+SimulationResult run_simulation(
+    const Network& network,
+    NetworkState initial_state,
+    const SimulationConfig& config,
+    SimulationArena& arena,
+    const SimulationCheckpoint* resume)
 {
     if (!network.is_finalized()) {
         throw std::invalid_argument("network must be finalized before simulation");
@@ -26,6 +167,33 @@ SimulationResult simulate_network(const Network& network, NetworkState initial_s
     if (initial_state.size() != neuron_count) {
         throw std::invalid_argument("initial_state size must match network size");
     }
+    if (config.skip_quiescent && !(config.quiescent_tolerance > 0.0)) {
+        throw std::invalid_argument("quiescent_tolerance must be > 0");
+    }
+
+    const bool takes_checkpoints = config.checkpoint.every_steps > 0 || config.checkpoint.write_final ||
+        config.checkpoint.keep_final;
+    const std::uint64_t network_fingerprint =
+        (resume != nullptr || takes_checkpoints) ? network.fingerprint() : 0U;
+
+    const std::uint32_t first_step = (resume != nullptr) ? resume->step : 0U;
+    if (resume != nullptr) {
+        if (resume->network_edges != network.edge_count() || resume->network_fingerprint != network_fingerprint) {
+            throw std::invalid_argument("checkpoint was taken on a different network");
+        }
+        if (resume->dt_ms != config.sim.dt_ms) {
+            throw std::invalid_argument("checkpoint dt_ms does not match config.sim.dt_ms");
+        }
+        if (resume->syn_current.size() != neuron_count) {
+            throw std::invalid_argument("checkpoint size must match network size");
+        }
+        if (first_step > config.sim.steps) {
+            throw std::invalid_argument("checkpoint step is past config.sim.steps");
+        }
+    }
+    // The RNG streams continue only on the run's own seed; a branch with
+    // another seed gets fresh streams derived from its seed and the step.
+    const bool same_seed = (resume != nullptr) && (resume->seed == config.sim.seed);
 
     SimulationResult result;
     result.final_state = std::move(initial_state);
@@ -33,115 +201,480 @@ SimulationResult simulate_network(const Network& network, NetworkState initial_s
         result.spikes.reserve(config.reserve_spike_events);
     }
 
-    std::vector<double> syn_current(neuron_count, 0.0);
-    std::vector<double> next_syn_current(neuron_count, 0.0);
-
     std::mt19937_64 rng(config.sim.seed);
     std::normal_distribution<double> noise_dist(0.0, config.noise_stddev);
+    if (same_seed && !resume->noise_rng.empty()) {
+        std::istringstream saved(resume->noise_rng);
+        if (!(saved >> rng >> noise_dist)) {
+            throw std::runtime_error("checkpoint holds a malformed noise RNG state");
+        }
+        // The saved variate is standard normal, so a changed sigma applies.
+        noise_dist.param(std::normal_distribution<double>::param_type(0.0, config.noise_stddev));
+    } else if (resume != nullptr) {
+        rng.seed(derive_seed(derive_seed(config.sim.seed, kResumedNoiseStream), first_step));
+    }
+
+    // Noise reaches every neuron every step, so nothing can rest.
+    const bool skip_quiescent = config.skip_quiescent && (config.noise_stddev <= 0.0);
 
+    // Noise draws come from one sequential stream in neuron order.
+    const bool parallel_update = (config.noise_stddev <= 0.0);
+    ExecutionPlan plan;
 #if IZHNET_HAS_OPENMP
-    if (config.sim.omp_threads > 0) {
-        omp_set_num_threads(config.sim.omp_threads);
-    }
-    const bool can_parallel = (config.noise_stddev <= 0.0) && (neuron_count >= 1024U);
-    std::vector<std::vector<std::uint32_t>> thread_spikes;
-    if (can_parallel) {
-        thread_spikes.resize(static_cast<std::size_t>(omp_get_max_threads()));
-        if (config.reserve_spike_events > 0 && !thread_spikes.empty()) {
-            const std::size_t per_thread = config.reserve_spike_events / thread_spikes.size();
-            for (auto& local : thread_spikes) {
-                local.reserve(per_thread);
-            }
-        }
+    const int max_threads = (config.sim.omp_threads > 0) ? config.sim.omp_threads : omp_get_max_threads();
+    if (parallel_update && neuron_count >= 1024U) {
+        plan.update_threads = max_threads;
     }
 #else
-    const bool can_parallel = false;
+    const int max_threads = 0; // every plan degrades to the serial loops
 #endif
 
-    const auto t0 = std::chrono::steady_clock::now();
+    std::unique_ptr<Autotuner> tuner;
+    std::string autotune_key;
+    if (config.plan) {
+        plan = *config.plan;
+    } else if (config.autotune.enabled) {
+        const AutotuneShape shape {
+            neuron_count,
+            network.edge_count(),
+            max_threads,
+            parallel_update,
+            skip_quiescent,
+            static_cast<std::uint8_t>(config.neuron.integrator)
+        };
+        autotune_key = autotune_cache_key(shape);
+        ExecutionPlan cached;
+        if (!config.autotune.cache_path.empty() && load_cached_plan(config.autotune.cache_path, autotune_key, cached)) {
+            plan = cached;
+        } else {
+            tuner = std::make_unique<Autotuner>(shape, config.autotune.steps_per_candidate);
+            plan = tuner->plan();
+        }
+    }
+
+    const bool may_use_threads = plan.update_threads > 0 || plan.propagation_threads > 0 || tuner;
+    const std::size_t thread_count = may_use_threads ? static_cast<std::size_t>(max_threads) : 0U;
+    // Euler spikes keep the step grid; the other schemes report the crossing.
+    const bool track_offsets = config.neuron.integrator != Integrator::Euler;
+    if (track_offsets && config.reserve_spike_events > 0) {
+        result.spike_offsets_ms.reserve(config.reserve_spike_events);
+    }
+    arena.prepare(neuron_count, thread_count, config.reserve_spike_events, skip_quiescent, track_offsets);
+    auto& syn_current = arena.syn_current;
+    auto& next_syn_current = arena.next_syn_current;
+    auto& step_spikes = arena.step_spikes;
+    if (resume != nullptr) {
+        std::copy(resume->syn_current.begin(), resume->syn_current.end(), syn_current.begin());
+    }
+
+    if (skip_quiescent) {
+        for (std::size_t i = 0; i < neuron_count; ++i) {
+            const double input = result.final_state.I[i] + config.tonic_current;
+            if (i > 0 && result.final_state.I[i] == result.final_state.I[i - 1U]) {
+                arena.rest_V[i] = arena.rest_V[i - 1U];
+                arena.rest_U[i] = arena.rest_U[i - 1U];
+            } else if (!resting_fixed_point(input, config.sim.dt_ms, config.neuron, arena.rest_V[i], arena.rest_U[i])) {
+                arena.rest_V[i] = std::numeric_limits<double>::quiet_NaN();
+            }
+            if (!std::isnan(arena.rest_V[i])) {
+                ++result.stats.resting_neurons;
+            }
+            arena.active[i] = static_cast<std::uint32_t>(i);
+        }
+        if (resume != nullptr && resume->awake.size() == neuron_count && resume->rest_signature == rest_signature(config)) {
+            std::copy(resume->awake.begin(), resume->awake.end(), arena.awake.begin());
+            arena.active.clear();
+            for (std::size_t i = 0; i < neuron_count; ++i) {
+                if (arena.awake[i]) {
+                    arena.active.push_back(static_cast<std::uint32_t>(i));
+                }
+            }
+        }
+    }
+
+    std::atomic<std::uint64_t> extra_crossings { 0 };
+
+    // Integrates one neuron; in active-set mode a neuron that stays below
+    // threshold without synaptic input and lands within tolerance of its
+    // fixed point is pinned there and leaves the active set.
+    const auto integrate = [&](std::size_t idx, double noise, bool& keep_active) {
+        const double syn = syn_current[idx];
+        const double total_current = result.final_state.I[idx] + config.tonic_current + syn + noise;
+
+        double spike_offset_ms = 0.0;
+        const int crossings = step_izhikevich(
+            result.final_state.V[idx],
+            result.final_state.U[idx],
+            total_current,
+            config.sim.dt_ms,
+            config.neuron,
+            spike_offset_ms);
+        const bool spiked = crossings > 0;
+        if (spiked && track_offsets) {
+            arena.spike_offset_ms[idx] = static_cast<float>(spike_offset_ms);
+        }
+        if (crossings > 1) {
+            extra_crossings.fetch_add(static_cast<std::uint64_t>(crossings - 1), std::memory_order_relaxed);
+        }
+
+        // Consumed here so propagation can accumulate into this buffer after
+        // the swap without a separate O(N) clear. Every neuron holding input
+        // is in the update set, including in active-set mode.
+        syn_current[idx] = 0.0;
+
+        keep_active = true;
+        if (skip_quiescent && !spiked && syn == 0.0) {
+            const double V_rest = arena.rest_V[idx];
+            const double U_rest = arena.rest_U[idx];
+            double& V = result.final_state.V[idx];
+            double& U = result.final_state.U[idx];
+            if (std::abs(V - V_rest) <= config.quiescent_tolerance && std::abs(U - U_rest) <= config.quiescent_tolerance) {
+                V = V_rest;
+                U = U_rest;
+                arena.awake[idx] = 0U;
+                keep_active = false;
+            }
+        }
+        return spiked;
+    };
+
+    // External events land in the buffer read at their step and wake the
+    // target like a recurrent spike would. A checkpoint already holds the
+    // input of its own step.
+    const std::uint64_t input_seed = (resume != nullptr)
+        ? derive_seed(derive_seed(config.sim.seed, kExternalInputStream), first_step)
+        : derive_seed(config.sim.seed, kExternalInputStream);
+    ExternalInput external(
+        config.poisson_inputs,
+        config.spike_train_inputs,
+        static_cast<std::uint32_t>(neuron_count),
+        config.sim.dt_ms,
+        input_seed,
+        (resume != nullptr) ? first_step + 1U : 0U);
+    const bool has_external = !external.empty();
+    // A snapshot from other inputs (a branch with a changed input list)
+    // cannot be continued; those streams start fresh, as with another seed.
+    if (resume != nullptr && has_external) {
+        result.stats.input_reseeded = !(same_seed && external.restore(resume->input));
+    }
+    const auto inject = [&](std::uint32_t step, AlignedVector<double>& buffer) {
+        external.deliver(step, [&](std::uint32_t target, double current) {
+            buffer[target] += current;
+            if (skip_quiescent && !arena.awake[target]) {
+                arena.awake[target] = 1U;
+                arena.woken.push_back(target);
+            }
+        });
+    };
+    if (has_external && resume == nullptr && config.sim.steps > 0) {
+        inject(0, syn_current);
+    }
+
+    // A checkpoint is taken at the top of a step, before step_spikes (the
+    // previous step's spikes) is cleared.
+    const bool final_checkpoint = config.checkpoint.write_final || config.checkpoint.keep_final;
+    std::unique_ptr<CheckpointWriter> checkpoint_writer;
+    if (config.checkpoint.every_steps > 0 || config.checkpoint.write_final) {
+        checkpoint_writer = std::make_unique<CheckpointWriter>(config.checkpoint.output_path);
+    }
+    const auto take_checkpoint = [&](SimulationCheckpoint& checkpoint, std::uint32_t step) {
+        checkpoint.step = step;
+        checkpoint.seed = config.sim.seed;
+        checkpoint.dt_ms = config.sim.dt_ms;
+        checkpoint.network_edges = network.edge_count();
+        checkpoint.network_fingerprint = network_fingerprint;
+        checkpoint.state.V = result.final_state.V;
+        checkpoint.state.U = result.final_state.U;
+        checkpoint.state.I = result.final_state.I;
+        checkpoint.state.spiked.assign(neuron_count, 0U);
+        for (const std::uint32_t neuron_id : step_spikes) {
+            checkpoint.state.spiked[neuron_id] = 1U;
+        }
+        checkpoint.syn_current = syn_current;
+        std::ostringstream noise_state;
+        noise_state << rng << ' ' << noise_dist;
+        checkpoint.noise_rng = noise_state.str();
+        checkpoint.input = external.snapshot();
+        if (skip_quiescent) {
+            checkpoint.awake = arena.awake;
+            checkpoint.rest_signature = rest_signature(config);
+        } else {
+            checkpoint.awake.clear();
+            checkpoint.rest_signature.clear();
+        }
+    };
+
+    std::unique_ptr<TraceRecorder> recorder;
+    if (!config.trace.neurons.empty()) {
+        recorder = std::make_unique<TraceRecorder>(config.trace, network.size(), config.sim.dt_ms);
+    }
+
     const auto& offsets = network.offsets();
     const auto& targets = network.targets();
     const auto& weights = network.weights();
 
-    for (std::uint32_t step = 0; step < config.sim.steps; ++step) {
-        if (can_parallel) {
+    // Plans from a cache may come from a run with other limits; clamp them
+    // to what this run can execute.
+    bool partition_ready = false;
+    const auto apply_plan = [&](const ExecutionPlan& next) {
+        plan = next;
+        plan.update_threads = parallel_update ? std::clamp(plan.update_threads, 0, max_threads) : 0;
+        plan.propagation_threads = std::clamp(plan.propagation_threads, 0, max_threads);
+        if (plan.propagation_threads == 0) {
+            return;
+        }
+        if (!partition_ready) {
+            arena.in_degree_prefix.assign(neuron_count + 1U, 0U);
+            for (const std::uint32_t target : targets) {
+                ++arena.in_degree_prefix[static_cast<std::size_t>(target) + 1U];
+            }
+            std::partial_sum(arena.in_degree_prefix.begin(), arena.in_degree_prefix.end(), arena.in_degree_prefix.begin());
+            partition_ready = true;
+        }
+        const auto parts = static_cast<std::size_t>(plan.propagation_threads);
+        const std::uint64_t edges = targets.size();
+        arena.target_bounds.resize(parts + 1U);
+        for (std::size_t part = 0; part <= parts; ++part) {
+            const auto cut = static_cast<std::uint32_t>(edges * part / parts);
+            const auto it = std::lower_bound(arena.in_degree_prefix.begin(), arena.in_degree_prefix.end(), cut);
+            arena.target_bounds[part] = static_cast<std::uint32_t>(it - arena.in_degree_prefix.begin());
+        }
+        arena.target_bounds.front() = 0U;
+        arena.target_bounds.back() = static_cast<std::uint32_t>(neuron_count);
+    };
+    apply_plan(plan);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    Timer step_timer;
+    std::uint64_t integrated_neuron_steps = 0;
+
+    for (std::uint32_t step = first_step; step < config.sim.steps; ++step) {
+        if (tuner) {
+            step_timer.reset();
+        }
+        if (checkpoint_writer && config.checkpoint.every_steps > 0 && step != first_step &&
+            step % config.checkpoint.every_steps == 0U) {
+            take_checkpoint(checkpoint_writer->acquire(), step);
+            checkpoint_writer->submit();
+        }
+        const std::size_t update_count = skip_quiescent ? arena.active.size() : neuron_count;
+        integrated_neuron_steps += update_count;
+        arena.next_active.clear();
+        step_spikes.clear();
+
+        if (recorder && recorder->due(step)) {
+            recorder->record(step, result.final_state.V, result.final_state.U, syn_current);
+        }
+
+        if (plan.update_threads > 0) {
 #if IZHNET_HAS_OPENMP
+            auto& thread_spikes = arena.thread_spikes;
+            auto& thread_active = arena.thread_active;
             for (auto& local : thread_spikes) {
                 local.clear();
             }
-#pragma omp parallel
+            for (auto& local : thread_active) {
+                local.clear();
+            }
+            const int chunk = static_cast<int>(plan.chunk);
+#pragma omp parallel num_threads(plan.update_threads)
             {
                 const int tid = omp_get_thread_num();
                 auto& local = thread_spikes[static_cast<std::size_t>(tid)];
-#pragma omp for schedule(static)
-                for (std::int64_t i = 0; i < static_cast<std::int64_t>(neuron_count); ++i) {
-                    const std::size_t idx = static_cast<std::size_t>(i);
-                    const double total_current = result.final_state.I[idx] + config.tonic_current + syn_current[idx];
-
-                    const bool spiked = step_izhikevich(
-                        result.final_state.V[idx],
-                        result.final_state.U[idx],
-                        total_current,
-                        config.sim.dt_ms,
-                        config.neuron);
-
-                    result.final_state.spiked[idx] = static_cast<std::uint8_t>(spiked ? 1U : 0U);
+                auto* local_active = skip_quiescent ? &thread_active[static_cast<std::size_t>(tid)] : nullptr;
+                const auto update = [&](std::int64_t i) {
+                    const std::size_t idx = skip_quiescent
+                        ? static_cast<std::size_t>(arena.active[static_cast<std::size_t>(i)])
+                        : static_cast<std::size_t>(i);
+
+                    bool keep_active = true;
+                    const bool spiked = integrate(idx, 0.0, keep_active);
                     if (spiked) {
                         local.push_back(static_cast<std::uint32_t>(idx));
                     }
+                    if (local_active != nullptr && keep_active) {
+                        local_active->push_back(static_cast<std::uint32_t>(idx));
+                    }
+                };
+                if (chunk == 0) {
+#pragma omp for schedule(static)
+                    for (std::int64_t i = 0; i < static_cast<std::int64_t>(update_count); ++i) {
+                        update(i);
+                    }
+                } else {
+#pragma omp for schedule(dynamic, chunk)
+                    for (std::int64_t i = 0; i < static_cast<std::int64_t>(update_count); ++i) {
+                        update(i);
+                    }
                 }
             }
 
             for (const auto& local : thread_spikes) {
-                for (const std::uint32_t neuron_id : local) {
-                    result.spikes.push_back(SpikeEvent { neuron_id, step });
+                step_spikes.insert(step_spikes.end(), local.begin(), local.end());
+            }
+            if (skip_quiescent) {
+                for (const auto& local : thread_active) {
+                    arena.next_active.insert(arena.next_active.end(), local.begin(), local.end());
                 }
             }
+            // Static blocks come back in id order; dynamic chunks do not,
+            // and propagation order must not depend on the plan.
+            if (chunk != 0) {
+                std::sort(step_spikes.begin(), step_spikes.end());
+                std::sort(arena.next_active.begin(), arena.next_active.end());
+            }
 #endif
         } else {
-            for (std::size_t i = 0; i < neuron_count; ++i) {
-                double total_current = result.final_state.I[i] + config.tonic_current + syn_current[i];
-                if (config.noise_stddev > 0.0) {
-                    total_current += noise_dist(rng);
-                }
-
-                const bool spiked = step_izhikevich(
-                    result.final_state.V[i],
-                    result.final_state.U[i],
-                    total_current,
-                    config.sim.dt_ms,
-                    config.neuron);
+            for (std::size_t i = 0; i < update_count; ++i) {
+                const std::size_t idx = skip_quiescent ? static_cast<std::size_t>(arena.active[i]) : i;
+                const double noise = (config.noise_stddev > 0.0) ? noise_dist(rng) : 0.0;
 
-                result.final_state.spiked[i] = static_cast<std::uint8_t>(spiked ? 1U : 0U);
+                bool keep_active = true;
+                const bool spiked = integrate(idx, noise, keep_active);
                 if (spiked) {
-                    result.spikes.push_back(SpikeEvent {
-                        static_cast<std::uint32_t>(i),
-                        step
-                    });
+                    step_spikes.push_back(static_cast<std::uint32_t>(idx));
+                }
+                if (skip_quiescent && keep_active) {
+                    arena.next_active.push_back(static_cast<std::uint32_t>(idx));
                 }
             }
         }
 
-        std::fill(next_syn_current.begin(), next_syn_current.end(), 0.0);
-        for (std::size_t source = 0; source < neuron_count; ++source) {
-            if (!result.final_state.spiked[source]) {
-                continue;
+        for (const std::uint32_t neuron_id : step_spikes) {
+            result.spikes.push_back(SpikeEvent { neuron_id, step });
+        }
+        if (track_offsets) {
+            for (const std::uint32_t neuron_id : step_spikes) {
+                result.spike_offsets_ms.push_back(arena.spike_offset_ms[neuron_id]);
             }
-            const std::size_t edge_begin = offsets[source];
-            const std::size_t edge_end = offsets[source + 1U];
-            for (std::size_t edge_idx = edge_begin; edge_idx < edge_end; ++edge_idx) {
-                next_syn_current[targets[edge_idx]] += weights[edge_idx];
+        }
+
+        if (plan.propagation_threads > 0 && !step_spikes.empty()) {
+#if IZHNET_HAS_OPENMP
+            // Each part owns a target range and walks the spiking rows in the
+            // same order as the serial loop, so every target accumulates its
+            // inputs in the same order. Rows are sorted by target.
+            const auto parts = static_cast<std::size_t>(plan.propagation_threads);
+#pragma omp parallel num_threads(plan.propagation_threads)
+            {
+                const auto team = static_cast<std::size_t>(omp_get_num_threads());
+                for (auto part = static_cast<std::size_t>(omp_get_thread_num()); part < parts; part += team) {
+                    const std::uint32_t lo = arena.target_bounds[part];
+                    const std::uint32_t hi = arena.target_bounds[part + 1U];
+                    auto& local_woken = arena.thread_woken[part];
+                    for (const std::uint32_t source : step_spikes) {
+                        const std::uint32_t* row_end = targets.data() + offsets[source + 1U];
+                        const std::uint32_t* it = std::lower_bound(targets.data() + offsets[source], row_end, lo);
+                        for (; it != row_end && *it < hi; ++it) {
+                            next_syn_current[*it] += weights[static_cast<std::size_t>(it - targets.data())];
+                            if (skip_quiescent && !arena.awake[*it]) {
+                                arena.awake[*it] = 1U;
+                                local_woken.push_back(*it);
+                            }
+                        }
+                    }
+                }
             }
+            if (skip_quiescent) {
+                for (std::size_t part = 0; part < parts; ++part) {
+                    auto& local_woken = arena.thread_woken[part];
+                    arena.woken.insert(arena.woken.end(), local_woken.begin(), local_woken.end());
+                    local_woken.clear();
+                }
+            }
+#endif
+        } else {
+            for (const std::uint32_t source : step_spikes) {
+                const std::size_t edge_begin = offsets[source];
+                const std::size_t edge_end = offsets[source + 1U];
+                for (std::size_t edge_idx = edge_begin; edge_idx < edge_end; ++edge_idx) {
+                    next_syn_current[targets[edge_idx]] += weights[edge_idx];
+                }
+                if (skip_quiescent) {
+                    for (std::size_t edge_idx = edge_begin; edge_idx < edge_end; ++edge_idx) {
+                        const std::uint32_t target = targets[edge_idx];
+                        if (!arena.awake[target]) {
+                            arena.awake[target] = 1U;
+                            arena.woken.push_back(target);
+                        }
+                    }
+                }
+            }
+        }
+        if (has_external && (step + 1U < config.sim.steps || final_checkpoint)) {
+            inject(step + 1U, next_syn_current);
         }
         syn_current.swap(next_syn_current);
+
+        if (skip_quiescent) {
+            // Survivors are already in id order; merging keeps the update
+            // (and therefore spike) order identical to full integration.
+            std::sort(arena.woken.begin(), arena.woken.end());
+            arena.active.resize(arena.next_active.size() + arena.woken.size());
+            std::merge(
+                arena.next_active.begin(), arena.next_active.end(),
+                arena.woken.begin(), arena.woken.end(),
+                arena.active.begin());
+            arena.woken.clear();
+        }
+
+        if (tuner) {
+            tuner->record_step(step_timer.elapsed_seconds());
+            apply_plan(tuner->plan());
+            if (tuner->done()) {
+                if (!config.autotune.cache_path.empty()) {
+                    try {
+                        store_cached_plan(config.autotune.cache_path, autotune_key, plan);
+                    } catch (const std::exception&) {
+                        // The cache only saves the next run its tuning steps.
+                    }
+                }
+                tuner.reset();
+            }
+        }
+    }
+
+    // Byte flags are only a view of the last step, filled once at the end.
+    if (config.sim.steps > first_step) {
+        std::fill(result.final_state.spiked.begin(), result.final_state.spiked.end(), std::uint8_t { 0U });
+        for (const std::uint32_t neuron_id : step_spikes) {
+            result.final_state.spiked[neuron_id] = 1U;
+        }
+    }
+
+    if (recorder) {
+        result.stats.trace_samples = recorder->samples_recorded();
+        recorder->close();
     }
 
+    if (final_checkpoint) {
+        SimulationCheckpoint checkpoint;
+        take_checkpoint(checkpoint, config.sim.steps);
+        if (config.checkpoint.write_final) {
+            checkpoint_writer->acquire() = checkpoint;
+            checkpoint_writer->submit();
+        }
+        if (config.checkpoint.keep_final) {
+            result.final_checkpoint = std::move(checkpoint);
+        }
+    }
+    if (checkpoint_writer) {
+        checkpoint_writer->close();
+        result.stats.checkpoints_written = checkpoint_writer->checkpoints_written();
+    }
+
+    result.stats.input_events = external.events_delivered();
+    result.stats.extra_crossings = extra_crossings.load(std::memory_order_relaxed);
+    result.stats.plan = plan;
+
     const auto t1 = std::chrono::steady_clock::now();
     result.stats.elapsed_seconds = std::chrono::duration<double>(t1 - t0).count();
     result.stats.total_spikes = result.spikes.size();
+    const std::uint64_t run_steps = config.sim.steps - first_step;
     result.stats.total_state_updates = static_cast<std::uint64_t>(2ULL) *
-        static_cast<std::uint64_t>(neuron_count) *
-        static_cast<std::uint64_t>(config.sim.steps);
+        static_cast<std::uint64_t>(neuron_count) * run_steps;
+    result.stats.skipped_neuron_steps =
+        static_cast<std::uint64_t>(neuron_count) * run_steps - integrated_neuron_steps;
 
     if (result.stats.elapsed_seconds > 0.0) {
         result.stats.state_updates_per_second =
@@ -150,9 +683,18 @@ SimulationResult simulate_network(const Network& network, NetworkState initial_s
         result.stats.state_updates_per_second = std::numeric_limits<double>::infinity();
     }
 
+    result.stats.memory.append(network.memory_report());
+    result.stats.memory.append(result.final_state.memory_report());
+    result.stats.memory.append(arena.memory_report());
+    if (recorder) {
+        result.stats.memory.append(recorder->memory_report());
+    }
+
     return result;
 }
 
+} // namespace
+
 std::vector<SimulationResult> simulate_batch(
     const Network& network,
     const NetworkState& initial_state,
@@ -160,8 +702,23 @@ std::vector<SimulationResult> simulate_batch(
 {
     std::vector<SimulationResult> results;
     results.reserve(configs.size());
+    SimulationArena arena;
+    for (const SimulationConfig& config : configs) {
+        results.push_back(simulate_network(network, initial_state, config, arena));
+    }
+    return results;
+}
+
+std::vector<SimulationResult> simulate_batch(
+    const Network& network,
+    const SimulationCheckpoint& checkpoint,
+    const std::vector<SimulationConfig>& configs)
+{
+    std::vector<SimulationResult> results;
+    results.reserve(configs.size());
+    SimulationArena arena;
     for (const SimulationConfig& config : configs) {
-        results.push_back(simulate_network(network, initial_state, config));
+        results.push_back(resume_simulation(network, checkpoint, config, arena));
     }
     return results;
 }
@@ -1,8 +1,16 @@
 #pragma once
 
+#include "izhnet/core/memory.hpp"
 #include "izhnet/core/types.hpp"
+#include "izhnet/io/trace_recorder.hpp"
 #include "izhnet/network/network.hpp"
+#include "izhnet/sim/autotune.hpp"
+#include "izhnet/sim/checkpoint.hpp"
+#include "izhnet/sim/external_input.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <vector>
 
 namespace izhnet {
@@ -13,6 +21,35 @@ struct SimulationConfig {
     double tonic_current = 0.0;
     double noise_stddev = 0.0;
     std::size_t reserve_spike_events = 0;
+
+    // Active-set mode: a neuron that receives no synaptic input and whose
+    // (V, U) is within quiescent_tolerance of its resting fixed point under
+    // I + tonic_current is pinned to that point and skipped until a spike
+    // reaches it. For quiescent_tolerance <= 1e-4, tests/test_quiescent.cpp
+    // checks identical spikes, |dU| <= 2 tol, |dV| <= 3 tol below -60 mV
+    // and |dV| <= 20 tol on a spike upstroke. Looser tolerances can shift
+    // spikes. Ignored when noise_stddev > 0.
+    bool skip_quiescent = false;
+    double quiescent_tolerance = 1e-6;
+
+    TraceConfig trace {}; // optional V/U/I traces of selected neurons
+
+    // External drive added to the synaptic current buffer. Poisson draws
+    // use a stream derived from sim.seed, independent of the noise stream.
+    std::vector<PoissonInput> poisson_inputs;
+    std::vector<SpikeTrainInput> spike_train_inputs;
+
+    // Without autotune, the update runs on sim.omp_threads (or the OpenMP
+    // default) threads once there are 1024 neurons and no noise, and
+    // propagation is serial. With it, the first steps of the run try other
+    // plans and the rest use the fastest. Results are identical either way.
+    AutotuneConfig autotune {};
+
+    // Forces one plan for the whole run, ahead of both the default and
+    // autotune; clamped to the threads available like a cached plan.
+    std::optional<ExecutionPlan> plan;
+
+    CheckpointConfig checkpoint {};
 };
 
 struct SimulationStats {
@@ -20,19 +57,92 @@ struct SimulationStats {
     std::uint64_t total_spikes = 0;
     double elapsed_seconds = 0.0;
     double state_updates_per_second = 0.0;
+    std::uint64_t skipped_neuron_steps = 0; // neuron updates saved by skip_quiescent
+    std::uint64_t resting_neurons = 0;      // neurons skip_quiescent could ever pin
+    std::uint64_t trace_samples = 0;
+    std::uint64_t input_events = 0; // Poisson and replayed events delivered
+    std::uint64_t extra_crossings = 0; // threshold crossings after the first in one step; they reset
+                                       // the neuron but are not emitted as separate spikes
+    MemoryReport memory; // network, state and scratch buffers at end of run
+    ExecutionPlan plan;  // plan in effect at the end of the run
+    std::uint64_t checkpoints_written = 0;
+    bool input_reseeded = false; // resumed, but the input streams restarted instead of continuing
 };
 
 struct SimulationResult {
     NetworkState final_state;
     std::vector<SpikeEvent> spikes;
+    std::vector<float> spike_offsets_ms; // spike time after step * dt, parallel to spikes;
+                                         // empty unless the integrator interpolates
     SimulationStats stats;
+    std::optional<SimulationCheckpoint> final_checkpoint; // set with checkpoint.keep_final
+};
+
+// Scratch state of the step loop. Buffers are only ever grown, so passing
+// the same arena to consecutive runs avoids reallocating per run.
+struct SimulationArena {
+    AlignedVector<double> syn_current;
+    AlignedVector<double> next_syn_current;
+    AlignedVector<std::uint32_t> step_spikes; // spiking neuron ids of the current step, ascending
+    std::vector<AlignedVector<std::uint32_t>> thread_spikes;
+    AlignedVector<float> spike_offset_ms; // per neuron, only sized for interpolating integrators
+
+    // Active-set bookkeeping, only sized when skip_quiescent is enabled.
+    AlignedVector<double> rest_V;
+    AlignedVector<double> rest_U;
+    AlignedVector<std::uint8_t> awake;
+    AlignedVector<std::uint32_t> active;
+    AlignedVector<std::uint32_t> next_active;
+    AlignedVector<std::uint32_t> woken;
+    std::vector<AlignedVector<std::uint32_t>> thread_active;
+
+    // Target-partitioned propagation: prefix sums of in-degree, used to cut
+    // targets into ranges of equal incoming edge count.
+    AlignedVector<std::uint32_t> in_degree_prefix;
+    std::vector<std::uint32_t> target_bounds;
+    std::vector<AlignedVector<std::uint32_t>> thread_woken;
+
+    void prepare(
+        std::size_t neuron_count,
+        std::size_t thread_count,
+        std::size_t reserve_spike_events,
+        bool track_active,
+        bool track_offsets);
+    MemoryReport memory_report() const;
 };
 
 SimulationResult simulate_network(const Network& network, NetworkState initial_state, const SimulationConfig& config);
 
+SimulationResult simulate_network(
+    const Network& network,
+    NetworkState initial_state,
+    const SimulationConfig& config,
+    SimulationArena& arena);
+
+// Continues a run from a checkpoint up to config.sim.steps, which counts
+// from the start of the original run. Spikes and stats cover only the
+// resumed steps. With the checkpoint's seed the run continues
+// bit-identically; with another seed the noise and Poisson streams restart
+// from that seed and the checkpoint step. Poisson and replay streams also
+// restart when the checkpoint's input state does not fit config's inputs
+// (a different list of sources); stats.input_reseeded reports either case.
+SimulationResult resume_simulation(const Network& network, const SimulationCheckpoint& checkpoint, const SimulationConfig& config);
+
+SimulationResult resume_simulation(
+    const Network& network,
+    const SimulationCheckpoint& checkpoint,
+    const SimulationConfig& config,
+    SimulationArena& arena);
+
 std::vector<SimulationResult> simulate_batch(
     const Network& network,
     const NetworkState& initial_state,
     const std::vector<SimulationConfig>& configs);
 
+// Branches every config from one checkpoint, e.g. a shared warm-up.
+std::vector<SimulationResult> simulate_batch(
+    const Network& network,
+    const SimulationCheckpoint& checkpoint,
+    const std::vector<SimulationConfig>& configs);
+
 } // namespace izhnet
@@ -1,16 +1,21 @@
+#include "izhnet/analysis/metrics.hpp"
 #include "izhnet/core/types.hpp"
+#include "izhnet/io/spike_archive.hpp"
 #include "izhnet/io/spike_logger.hpp"
 #include "izhnet/network/network.hpp"
 #include "izhnet/sim/simulator.hpp"
 
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -18,6 +23,7 @@ struct CliOptions {
     std::uint32_t n = 1000;
     std::uint32_t steps = 1000;
     std::uint64_t seed = 1;
+    std::optional<std::uint64_t> network_seed; // defaults to seed
     std::uint32_t out_degree = 20;
     double dt_ms = 0.1;
     double weight_min = 0.1;
@@ -30,18 +36,50 @@ struct CliOptions {
     double sweep_current_start = 6.0;
     double sweep_current_step = 0.1;
     bool allow_self_connections = false;
+    bool report_memory = false;
+    bool skip_quiescent = false;
+    double quiescent_tolerance = 1e-6;
+    double v_min = izhnet::IzhParams {}.V_min;
+    izhnet::HugePages huge_pages = izhnet::HugePages::Off;
+    izhnet::Integrator integrator = izhnet::Integrator::Euler;
+    bool consistent_integration = true;
     std::string out_path = "data/spikes.csv";
+    std::vector<std::uint32_t> trace_neurons;
+    std::uint32_t trace_every = 1;
+    std::string trace_path = "data/trace.bin";
+    std::string archive_path;
+    bool archive_neuron_index = false;
+    std::vector<izhnet::PoissonInput> poisson_inputs;
+    std::string input_spikes_path;
+    double input_weight = 1.0;
+    bool autotune = false;
+    std::uint32_t autotune_steps = 8;
+    std::string autotune_cache = izhnet::default_autotune_cache_path();
+    std::uint32_t checkpoint_every = 0;
+    bool checkpoint_final = false;
+    std::string checkpoint_path = "data/checkpoint.izck";
+    std::string resume_path;
+};
+
+struct QueryOptions {
+    std::string archive_path;
+    double t0_ms = 0.0;
+    double t1_ms = -1.0; // < 0: end of archive
+    std::vector<std::uint32_t> neurons;
+    std::string out_path; // empty: stdout
 };
 
 void print_usage(const char* program)
 {
     std::cout
         << "Usage: " << program << " [options]\n"
+        << "       " << program << " query --archive <path> [query options]\n"
         << "Options:\n"
         << "  --n <int>                    Number of neurons (default: 1000)\n"
         << "  --steps <int>                Number of time steps (default: 1000)\n"
         << "  --dt <float>                 Time step in ms (default: 0.1)\n"
         << "  --seed <int>                 Base RNG seed (default: 1)\n"
+        << "  --network-seed <int>         Seed of the random network (default: --seed)\n"
         << "  --out <path>                 Output CSV path (default: data/spikes.csv)\n"
         << "  --out-degree <int>           Outgoing edges per neuron (default: 20)\n"
         << "  --w-min <float>              Minimum synaptic weight (default: 0.1)\n"
@@ -54,7 +92,35 @@ void print_usage(const char* program)
         << "  --sweep-current-start <f>    Sweep start current (default: 6.0)\n"
         << "  --sweep-current-step <f>     Sweep current increment (default: 0.1)\n"
         << "  --allow-self-connections     Allow source==target edges\n"
-        << "  --help                       Show this help\n";
+        << "  --integrator <name>          euler, published, rk2, rk4 or expeuler (default: euler)\n"
+        << "  --v-min <float>              Lower clamp on the membrane potential (default: -1.79)\n"
+        << "  --skip-quiescent             Skip neurons resting at their fixed point\n"
+        << "  --quiescent-tol <float>      Fixed-point tolerance for --skip-quiescent (default: 1e-6)\n"
+        << "  --trace-neurons <list>       Trace V/U/I of neurons, e.g. 0,5,10-19\n"
+        << "  --trace-every <int>          Trace every k-th step (default: 1)\n"
+        << "  --trace-out <path>           Binary trace path (default: data/trace.bin)\n"
+        << "  --poisson <rate:w[:a-b]>     Poisson drive at rate Hz and weight w onto neurons a..b\n"
+        << "                               (default: all); repeatable\n"
+        << "  --input-spikes <path>        Replay a spike CSV or .izsa archive as input\n"
+        << "  --input-weight <float>       Current per replayed spike (default: 1.0)\n"
+        << "  --archive <path>             Also write an indexed spike archive\n"
+        << "  --archive-neuron-index       Add a per-neuron index to the archive\n"
+        << "  --autotune                   Time thread/schedule/propagation plans on the first steps\n"
+        << "  --autotune-steps <int>       Timed steps per candidate plan (default: 8)\n"
+        << "  --autotune-cache <path>      Plan cache (default: ~/.cache/izhnet/autotune.tsv); '' disables\n"
+        << "  --checkpoint-every <int>     Write a checkpoint every k steps (default: off)\n"
+        << "  --checkpoint-final           Write a checkpoint after the last step\n"
+        << "  --checkpoint-out <path>      Checkpoint path (default: data/checkpoint.izck)\n"
+        << "  --resume <path>              Continue from a checkpoint up to --steps; sweeps branch from it\n"
+        << "  --huge-pages <mode>          off, thp or explicit for large buffers (default: off)\n"
+        << "  --report-memory              Print per-buffer memory footprint\n"
+        << "  --help                       Show this help\n"
+        << "Query options:\n"
+        << "  --archive <path>             Spike archive written with --archive\n"
+        << "  --t0-ms <float>              Window start, inclusive (default: 0)\n"
+        << "  --t1-ms <float>              Window end, exclusive (default: end of run)\n"
+        << "  --neurons <list>             Only these neurons, e.g. 0,5,10-19\n"
+        << "  --out <path>                 Output CSV path (default: stdout)\n";
 }
 
 std::string require_value(int argc, char** argv, int& index, const std::string& option)
@@ -102,6 +168,101 @@ double parse_double(const std::string& text, const std::string& option)
     return std::stod(text);
 }
 
+izhnet::HugePages parse_huge_pages(const std::string& text, const std::string& option)
+{
+    if (text == "off") {
+        return izhnet::HugePages::Off;
+    }
+    if (text == "thp") {
+        return izhnet::HugePages::Transparent;
+    }
+    if (text == "explicit") {
+        return izhnet::HugePages::Explicit;
+    }
+    throw std::invalid_argument(option + " must be one of: off, thp, explicit");
+}
+
+void parse_integrator(const std::string& text, const std::string& option, CliOptions& options)
+{
+    options.consistent_integration = true;
+    if (text == "euler") {
+        options.integrator = izhnet::Integrator::Euler;
+    } else if (text == "published") {
+        options.integrator = izhnet::Integrator::Euler;
+        options.consistent_integration = false;
+    } else if (text == "rk2") {
+        options.integrator = izhnet::Integrator::RK2;
+    } else if (text == "rk4") {
+        options.integrator = izhnet::Integrator::RK4;
+    } else if (text == "expeuler") {
+        options.integrator = izhnet::Integrator::ExponentialEuler;
+    } else {
+        throw std::invalid_argument(option + " must be one of: euler, published, rk2, rk4, expeuler");
+    }
+}
+
+std::vector<std::uint32_t> parse_id_list(const std::string& text, const std::string& option)
+{
+    std::vector<std::uint32_t> ids;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (item.empty()) {
+            continue;
+        }
+        const std::size_t dash = item.find('-');
+        if (dash == std::string::npos) {
+            ids.push_back(parse_u32(item, option));
+            continue;
+        }
+        const std::uint32_t first = parse_u32(item.substr(0, dash), option);
+        const std::uint32_t last = parse_u32(item.substr(dash + 1U), option);
+        if (first > last) {
+            throw std::invalid_argument(option + " has a descending range: " + item);
+        }
+        for (std::uint32_t id = first; id <= last; ++id) {
+            ids.push_back(id);
+            if (id == last) {
+                break;
+            }
+        }
+    }
+    if (ids.empty()) {
+        throw std::invalid_argument(option + " must list at least one id");
+    }
+    return ids;
+}
+
+// rate_hz:weight[:first-last]; the neuron range defaults to the whole network
+// and is resolved once --n is known.
+izhnet::PoissonInput parse_poisson(const std::string& text, const std::string& option)
+{
+    izhnet::PoissonInput input;
+    std::stringstream stream(text);
+    std::string rate;
+    std::string weight;
+    std::string range;
+    if (!std::getline(stream, rate, ':') || !std::getline(stream, weight, ':')) {
+        throw std::invalid_argument(option + " expects rate_hz:weight[:first-last]");
+    }
+    input.rate_hz = parse_double(rate, option);
+    input.weight = parse_double(weight, option);
+    if (input.rate_hz < 0.0) {
+        throw std::invalid_argument(option + " rate must be >= 0");
+    }
+    if (std::getline(stream, range, ':')) {
+        const std::size_t dash = range.find('-');
+        const std::uint32_t first = parse_u32(range.substr(0, dash), option);
+        const std::uint32_t last = (dash == std::string::npos) ? first : parse_u32(range.substr(dash + 1U), option);
+        if (first > last) {
+            throw std::invalid_argument(option + " has a descending range: " + range);
+        }
+        input.first_neuron = first;
+        input.neuron_count = last - first + 1U;
+    }
+    return input;
+}
+
 enum class ParseResult {
     Ok,
     Help
@@ -119,6 +280,90 @@ ParseResult parse_args(int argc, char** argv, CliOptions& options)
             options.allow_self_connections = true;
             continue;
         }
+        if (arg == "--integrator") {
+            parse_integrator(require_value(argc, argv, i, arg), arg, options);
+            continue;
+        }
+        if (arg == "--v-min") {
+            options.v_min = parse_double(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
+        if (arg == "--skip-quiescent") {
+            options.skip_quiescent = true;
+            continue;
+        }
+        if (arg == "--quiescent-tol") {
+            options.quiescent_tolerance = parse_double(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
+        if (arg == "--trace-neurons") {
+            options.trace_neurons = parse_id_list(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
+        if (arg == "--trace-every") {
+            options.trace_every = parse_u32(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
+        if (arg == "--trace-out") {
+            options.trace_path = require_value(argc, argv, i, arg);
+            continue;
+        }
+        if (arg == "--poisson") {
+            options.poisson_inputs.push_back(parse_poisson(require_value(argc, argv, i, arg), arg));
+            continue;
+        }
+        if (arg == "--input-spikes") {
+            options.input_spikes_path = require_value(argc, argv, i, arg);
+            continue;
+        }
+        if (arg == "--input-weight") {
+            options.input_weight = parse_double(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
+        if (arg == "--archive") {
+            options.archive_path = require_value(argc, argv, i, arg);
+            continue;
+        }
+        if (arg == "--archive-neuron-index") {
+            options.archive_neuron_index = true;
+            continue;
+        }
+        if (arg == "--autotune") {
+            options.autotune = true;
+            continue;
+        }
+        if (arg == "--autotune-steps") {
+            options.autotune_steps = parse_u32(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
+        if (arg == "--autotune-cache") {
+            options.autotune_cache = require_value(argc, argv, i, arg);
+            continue;
+        }
+        if (arg == "--checkpoint-every") {
+            options.checkpoint_every = parse_u32(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
+        if (arg == "--checkpoint-final") {
+            options.checkpoint_final = true;
+            continue;
+        }
+        if (arg == "--checkpoint-out") {
+            options.checkpoint_path = require_value(argc, argv, i, arg);
+            continue;
+        }
+        if (arg == "--resume") {
+            options.resume_path = require_value(argc, argv, i, arg);
+            continue;
+        }
+        if (arg == "--report-memory") {
+            options.report_memory = true;
+            continue;
+        }
+        if (arg == "--huge-pages") {
+            options.huge_pages = parse_huge_pages(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
         if (arg == "--n") {
             options.n = parse_u32(require_value(argc, argv, i, arg), arg);
             continue;
@@ -135,6 +380,10 @@ ParseResult parse_args(int argc, char** argv, CliOptions& options)
             options.seed = parse_u64(require_value(argc, argv, i, arg), arg);
             continue;
         }
+        if (arg == "--network-seed") {
+            options.network_seed = parse_u64(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
         if (arg == "--out") {
             options.out_path = require_value(argc, argv, i, arg);
             continue;
@@ -204,11 +453,116 @@ ParseResult parse_args(int argc, char** argv, CliOptions& options)
     if (options.sweeps == 0) {
         throw std::invalid_argument("--sweeps must be > 0");
     }
+    if (options.autotune_steps == 0) {
+        throw std::invalid_argument("--autotune-steps must be > 0");
+    }
+    if (options.trace_every == 0) {
+        throw std::invalid_argument("--trace-every must be > 0");
+    }
+    for (const std::uint32_t neuron_id : options.trace_neurons) {
+        if (neuron_id >= options.n) {
+            throw std::invalid_argument("--trace-neurons id out of range for --n");
+        }
+    }
+    if (options.quiescent_tolerance <= 0.0) {
+        throw std::invalid_argument("--quiescent-tol must be > 0");
+    }
+    for (izhnet::PoissonInput& input : options.poisson_inputs) {
+        if (input.neuron_count == 0) {
+            input.neuron_count = options.n;
+        }
+        if (static_cast<std::uint64_t>(input.first_neuron) + input.neuron_count > options.n) {
+            throw std::invalid_argument("--poisson neuron range out of range for --n");
+        }
+    }
+
+    return ParseResult::Ok;
+}
+
+ParseResult parse_query_args(int argc, char** argv, QueryOptions& options)
+{
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg(argv[i]);
+
+        if (arg == "--help") {
+            return ParseResult::Help;
+        }
+        if (arg == "--archive") {
+            options.archive_path = require_value(argc, argv, i, arg);
+            continue;
+        }
+        if (arg == "--t0-ms") {
+            options.t0_ms = parse_double(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
+        if (arg == "--t1-ms") {
+            options.t1_ms = parse_double(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
+        if (arg == "--neurons") {
+            options.neurons = parse_id_list(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
+        if (arg == "--out") {
+            options.out_path = require_value(argc, argv, i, arg);
+            continue;
+        }
+
+        throw std::invalid_argument("unknown query option: " + arg);
+    }
 
+    if (options.archive_path.empty()) {
+        throw std::invalid_argument("query requires --archive");
+    }
     return ParseResult::Ok;
 }
 
-std::filesystem::path output_path_for_run(const std::string& out_path, std::uint32_t run_index, std::uint32_t run_count)
+int run_query(const QueryOptions& options)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    const izhnet::SpikeArchive archive(options.archive_path);
+    const izhnet::SpikeArchiveInfo& info = archive.info();
+    const double t1_ms = (options.t1_ms >= 0.0) ? options.t1_ms : static_cast<double>(info.step_count) * info.dt_ms;
+
+    std::vector<izhnet::SpikeEvent> spikes;
+    std::vector<float> offsets_ms;
+    if (options.neurons.empty()) {
+        const auto window = archive.window(options.t0_ms, t1_ms);
+        spikes.assign(window.begin(), window.end());
+        const auto window_offsets = archive.offsets_ms(window);
+        offsets_ms.assign(window_offsets.begin(), window_offsets.end());
+    } else {
+        spikes = archive.neurons(
+            options.neurons, archive.step_at_or_after(options.t0_ms), archive.step_at_or_after(t1_ms), &offsets_ms);
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+
+    if (options.out_path.empty()) {
+        std::cout << "time_ms,neuron_id,step\n" << std::fixed << std::setprecision(3);
+        for (std::size_t i = 0; i < spikes.size(); ++i) {
+            const izhnet::SpikeEvent& event = spikes[i];
+            const double offset_ms = offsets_ms.empty() ? 0.0 : offsets_ms[i];
+            std::cout << (static_cast<double>(event.step) * info.dt_ms + offset_ms) << "," << event.neuron_id << ","
+                      << event.step << "\n";
+        }
+    } else {
+        izhnet::write_spikes_csv(options.out_path, spikes, info.dt_ms, true, offsets_ms);
+    }
+
+    std::cerr
+        << "query events=" << spikes.size()
+        << " query_ms=" << std::fixed << std::setprecision(3)
+        << std::chrono::duration<double, std::milli>(t1 - t0).count()
+        << "\n";
+    return 0;
+}
+
+std::filesystem::path output_path_for_run(
+    const std::string& out_path,
+    std::uint32_t run_index,
+    std::uint32_t run_count,
+    const std::string& default_stem = "spikes",
+    const std::string& default_extension = ".csv")
 {
     const std::filesystem::path base(out_path);
     if (run_count <= 1) {
@@ -217,7 +571,7 @@ std::filesystem::path output_path_for_run(const std::string& out_path, std::uint
 
     if (base.extension().empty()) {
         std::ostringstream filename;
-        filename << "spikes_run_" << std::setw(4) << std::setfill('0') << run_index << ".csv";
+        filename << default_stem << "_run_" << std::setw(4) << std::setfill('0') << run_index << default_extension;
         return base / filename.str();
     }
 
@@ -232,6 +586,15 @@ std::filesystem::path output_path_for_run(const std::string& out_path, std::uint
 int main(int argc, char** argv)
 {
     try {
+        if (argc > 1 && std::string(argv[1]) == "query") {
+            QueryOptions query;
+            if (parse_query_args(argc, argv, query) == ParseResult::Help) {
+                print_usage(argv[0]);
+                return 0;
+            }
+            return run_query(query);
+        }
+
         CliOptions options;
         const ParseResult parse_result = parse_args(argc, argv, options);
         if (parse_result == ParseResult::Help) {
@@ -239,29 +602,62 @@ int main(int argc, char** argv)
             return 0;
         }
 
+        izhnet::set_huge_pages(options.huge_pages);
+
         const izhnet::Network network = izhnet::Network::random_fixed_out_degree(
             options.n,
             options.out_degree,
             options.weight_min,
             options.weight_max,
-            options.seed,
+            options.network_seed.value_or(options.seed),
             options.allow_self_connections);
 
         izhnet::NetworkState initial;
         izhnet::initial_state(initial, options.n, -65.0, -13.0, 0.0);
 
+        std::optional<izhnet::SimulationCheckpoint> resume;
+        if (!options.resume_path.empty()) {
+            resume = izhnet::read_checkpoint(options.resume_path);
+            if (resume->state.size() != options.n) {
+                throw std::invalid_argument("--resume checkpoint was written for a different --n");
+            }
+            if (resume->network_edges != network.edge_count() || resume->network_fingerprint != network.fingerprint()) {
+                throw std::invalid_argument(
+                    "--resume checkpoint was written for a different network; "
+                    "check --network-seed, --out-degree, --w-min and --w-max");
+            }
+        }
+
         izhnet::SimulationConfig base_config;
         base_config.sim.dt_ms = options.dt_ms;
         base_config.sim.steps = options.steps;
         base_config.sim.seed = options.seed;
         base_config.sim.omp_threads = options.omp_threads;
+        base_config.neuron.integrator = options.integrator;
+        base_config.neuron.consistent_integration = options.consistent_integration;
         base_config.tonic_current = options.tonic_current;
         base_config.noise_stddev = options.noise_stddev;
         base_config.reserve_spike_events = options.reserve_spikes;
+        base_config.neuron.V_min = options.v_min;
+        base_config.skip_quiescent = options.skip_quiescent;
+        base_config.quiescent_tolerance = options.quiescent_tolerance;
+        base_config.trace.neurons = options.trace_neurons;
+        base_config.trace.every_steps = options.trace_every;
+        base_config.poisson_inputs = options.poisson_inputs;
+        base_config.autotune.enabled = options.autotune;
+        base_config.autotune.steps_per_candidate = options.autotune_steps;
+        base_config.autotune.cache_path = options.autotune_cache;
+        base_config.checkpoint.every_steps = options.checkpoint_every;
+        base_config.checkpoint.write_final = options.checkpoint_final;
+        if (!options.input_spikes_path.empty()) {
+            base_config.spike_train_inputs.push_back(
+                izhnet::load_spike_train(options.input_spikes_path, options.dt_ms, options.input_weight));
+        }
 
         std::uint64_t total_spikes = 0;
         std::uint64_t total_updates = 0;
         double total_elapsed_s = 0.0;
+        izhnet::SimulationArena arena;
 
         for (std::uint32_t run = 0; run < options.sweeps; ++run) {
             izhnet::SimulationConfig run_config = base_config;
@@ -270,11 +666,45 @@ int main(int argc, char** argv)
                 run_config.tonic_current = options.sweep_current_start + options.sweep_current_step * static_cast<double>(run);
             }
 
-            izhnet::SimulationResult result = izhnet::simulate_network(network, initial, run_config);
+            if (!run_config.trace.neurons.empty()) {
+                run_config.trace.output_path = output_path_for_run(options.trace_path, run, options.sweeps, "trace", ".bin").string();
+            }
+
+            if (run_config.checkpoint.every_steps > 0 || run_config.checkpoint.write_final) {
+                run_config.checkpoint.output_path =
+                    output_path_for_run(options.checkpoint_path, run, options.sweeps, "checkpoint", ".izck").string();
+            }
+
+            izhnet::SimulationResult result = resume
+                ? izhnet::resume_simulation(network, *resume, run_config, arena)
+                : izhnet::simulate_network(network, initial, run_config, arena);
+
+            // Rates of a resumed run cover only the steps it simulated.
+            const std::uint32_t first_step = resume ? resume->step : 0U;
+            std::vector<izhnet::SpikeEvent> window_spikes;
+            if (first_step > 0) {
+                window_spikes.reserve(result.spikes.size());
+                for (const izhnet::SpikeEvent& event : result.spikes) {
+                    window_spikes.push_back(izhnet::SpikeEvent { event.neuron_id, event.step - first_step });
+                }
+            }
+            const izhnet::SpikeMetrics metrics = izhnet::compute_spike_metrics(
+                (first_step > 0) ? window_spikes : result.spikes, options.n,
+                run_config.sim.steps - first_step, run_config.sim.dt_ms);
 
             const std::filesystem::path run_output = output_path_for_run(options.out_path, run, options.sweeps);
             const izhnet::SpikeLogSummary summary =
-                izhnet::write_spikes_csv(run_output.string(), result.spikes, run_config.sim.dt_ms, true);
+                izhnet::write_spikes_csv(
+                    run_output.string(), result.spikes, run_config.sim.dt_ms, true, result.spike_offsets_ms);
+
+            if (!options.archive_path.empty()) {
+                izhnet::SpikeArchiveOptions archive_options;
+                archive_options.neuron_index = options.archive_neuron_index;
+                izhnet::write_spike_archive(
+                    output_path_for_run(options.archive_path, run, options.sweeps, "spikes", ".izsa").string(),
+                    result.spikes, options.n, run_config.sim.steps, run_config.sim.dt_ms, archive_options,
+                    result.spike_offsets_ms);
+            }
 
             total_spikes += result.stats.total_spikes;
             total_updates += result.stats.total_state_updates;
@@ -285,8 +715,41 @@ int main(int argc, char** argv)
                 << " out=" << run_output.string()
                 << " spikes=" << summary.events_written
                 << " duration_ms=" << summary.duration_ms
-                << " updates_per_s=" << std::fixed << std::setprecision(3) << result.stats.state_updates_per_second
-                << "\n";
+                << " mean_rate_hz=" << metrics.mean_rate_hz
+                << " updates_per_s=" << std::fixed << std::setprecision(3) << result.stats.state_updates_per_second;
+            if (options.skip_quiescent) {
+                std::cout << " skipped_neuron_steps=" << result.stats.skipped_neuron_steps;
+                if (result.stats.resting_neurons == 0 && options.noise_stddev <= 0.0) {
+                    std::cerr << "warning: --skip-quiescent cannot skip anything: no neuron has a stable "
+                                 "resting point at this --tonic-current, --v-min and --dt\n";
+                }
+            }
+            if (options.autotune) {
+                const izhnet::ExecutionPlan& plan = result.stats.plan;
+                std::cout << " plan=update:" << plan.update_threads << ",chunk:" << plan.chunk
+                          << ",propagation:" << plan.propagation_threads;
+            }
+            if (result.stats.input_events > 0) {
+                std::cout << " input_events=" << result.stats.input_events;
+            }
+            if (result.stats.input_reseeded && resume && resume->seed == run_config.sim.seed) {
+                std::cerr << "warning: the checkpoint's input state does not fit the configured inputs; "
+                             "Poisson and replay streams restarted\n";
+            }
+            if (result.stats.extra_crossings > 0) {
+                std::cout << " extra_crossings=" << result.stats.extra_crossings;
+                std::cerr << "warning: " << result.stats.extra_crossings
+                          << " threshold crossings fell in a step that had already spiked; "
+                             "they were integrated but not logged, consider a smaller --dt\n";
+            }
+            std::cout << "\n";
+
+            if (options.report_memory && run == 0) {
+                for (const izhnet::BufferFootprint& buffer : result.stats.memory.buffers) {
+                    std::cout << "memory buffer=" << buffer.name << " bytes=" << buffer.bytes << "\n";
+                }
+                std::cout << "memory total_bytes=" << result.stats.memory.total_bytes() << "\n";
+            }
         }
 
         const double aggregate_updates_per_s = (total_elapsed_s > 0.0)
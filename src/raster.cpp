@@ -0,0 +1,161 @@
+#include "izhnet/io/raster_renderer.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+struct CliOptions {
+    std::string input_path;
+    std::string output_path;
+    izhnet::RasterOptions raster {};
+};
+
+void print_usage(const char* program)
+{
+    std::cout
+        << "Usage: " << program << " --input <spikes.csv> --output <image.png|image.ppm> [options]\n"
+        << "Options:\n"
+        << "  --input <path>               Spike CSV with time_ms,neuron_id columns\n"
+        << "  --output <path>              Output image; .png or PPM otherwise\n"
+        << "  --width <int>                Image width / time bins (default: 1600)\n"
+        << "  --height <int>               Raster panel height / neuron bins (default: 800)\n"
+        << "  --rate-height <int>          Population-rate panel height; 0 disables (default: 200)\n"
+        << "  --start-ms <float>           Lower time bound (default: 0)\n"
+        << "  --end-ms <float>             Upper time bound (default: last spike in file)\n"
+        << "  --neurons <int>              Neuron count; 0 infers it from the data (default: 0)\n"
+        << "  --chunk-mb <int>             Read chunk size in MiB (default: 32)\n"
+        << "  --threads <int>              OpenMP threads; 0 uses runtime default\n"
+        << "  --help                       Show this help\n";
+}
+
+std::string require_value(int argc, char** argv, int& index, const std::string& option)
+{
+    if (index + 1 >= argc) {
+        throw std::invalid_argument("missing value for " + option);
+    }
+    ++index;
+    return std::string(argv[index]);
+}
+
+std::uint32_t parse_u32(const std::string& text, const std::string& option)
+{
+    const unsigned long long value = std::stoull(text);
+    if (value > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument(option + " out of range for uint32");
+    }
+    return static_cast<std::uint32_t>(value);
+}
+
+enum class ParseResult {
+    Ok,
+    Help
+};
+
+ParseResult parse_args(int argc, char** argv, CliOptions& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+
+        if (arg == "--help") {
+            return ParseResult::Help;
+        }
+        if (arg == "--input") {
+            options.input_path = require_value(argc, argv, i, arg);
+            continue;
+        }
+        if (arg == "--output") {
+            options.output_path = require_value(argc, argv, i, arg);
+            continue;
+        }
+        if (arg == "--width") {
+            options.raster.width = parse_u32(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
+        if (arg == "--height") {
+            options.raster.height = parse_u32(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
+        if (arg == "--rate-height") {
+            options.raster.rate_height = parse_u32(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
+        if (arg == "--start-ms") {
+            options.raster.start_ms = std::stod(require_value(argc, argv, i, arg));
+            continue;
+        }
+        if (arg == "--end-ms") {
+            options.raster.end_ms = std::stod(require_value(argc, argv, i, arg));
+            continue;
+        }
+        if (arg == "--neurons") {
+            options.raster.neuron_count = parse_u32(require_value(argc, argv, i, arg), arg);
+            continue;
+        }
+        if (arg == "--chunk-mb") {
+            options.raster.chunk_bytes = static_cast<std::size_t>(parse_u32(require_value(argc, argv, i, arg), arg)) << 20U;
+            continue;
+        }
+        if (arg == "--threads") {
+            options.raster.threads = static_cast<int>(parse_u32(require_value(argc, argv, i, arg), arg));
+            continue;
+        }
+
+        throw std::invalid_argument("unknown option: " + arg);
+    }
+
+    if (options.input_path.empty() || options.output_path.empty()) {
+        throw std::invalid_argument("--input and --output are required");
+    }
+    if (options.raster.width == 0 || options.raster.height == 0) {
+        throw std::invalid_argument("--width and --height must be > 0");
+    }
+    if (options.raster.chunk_bytes == 0) {
+        throw std::invalid_argument("--chunk-mb must be > 0");
+    }
+
+    return ParseResult::Ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    try {
+        CliOptions options;
+        const ParseResult parse_result = parse_args(argc, argv, options);
+        if (parse_result == ParseResult::Help) {
+            print_usage(argv[0]);
+            return 0;
+        }
+
+        const auto t0 = std::chrono::steady_clock::now();
+        izhnet::RasterImage image;
+        const izhnet::RasterSummary summary = izhnet::render_spike_raster(options.input_path, options.raster, image);
+        izhnet::write_raster_image(options.output_path, image);
+        const auto t1 = std::chrono::steady_clock::now();
+
+        std::cout
+            << "out=" << options.output_path
+            << " events=" << summary.events_binned
+            << " skipped=" << summary.events_skipped
+            << " neurons=" << summary.neuron_count
+            << " neurons_per_row=" << summary.neurons_per_row
+            << std::fixed << std::setprecision(3)
+            << " start_ms=" << summary.start_ms
+            << " end_ms=" << summary.end_ms
+            << " peak_rate_hz=" << summary.peak_rate_hz
+            << " elapsed_s=" << std::chrono::duration<double>(t1 - t0).count()
+            << "\n";
+        return 0;
+    } catch (const std::exception& ex) {
+        std::cerr << "error: " << ex.what() << "\n";
+        std::cerr << "use --help for options\n";
+        return 1;
+    }
+}
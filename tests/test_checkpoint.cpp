@@ -0,0 +1,177 @@
+// A run resumed from a checkpoint must continue bit-identically: the spikes
+// after the checkpoint step and the final V and U equal those of the
+// uninterrupted run, for in-memory and on-disk checkpoints alike.
+
+#include "izhnet/network/network.hpp"
+#include "izhnet/sim/checkpoint.hpp"
+#include "izhnet/sim/simulator.hpp"
+#include "test_support.hpp"
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace izhnet::test;
+
+namespace {
+
+void check_resume(
+    const std::string& label,
+    const izhnet::Network& network,
+    const izhnet::SimulationCheckpoint& checkpoint,
+    const izhnet::SimulationConfig& config,
+    const izhnet::SimulationResult& full)
+{
+    const izhnet::SimulationResult resumed = izhnet::resume_simulation(network, checkpoint, config);
+    check(same_spikes(resumed.spikes, tail(full.spikes, checkpoint.step)), label + ": spikes after the checkpoint match");
+    const std::size_t skipped = full.spikes.size() - resumed.spikes.size();
+    check(full.spike_offsets_ms.empty()
+            ? resumed.spike_offsets_ms.empty()
+            : std::vector<float>(full.spike_offsets_ms.begin() + static_cast<std::ptrdiff_t>(skipped),
+                  full.spike_offsets_ms.end()) == resumed.spike_offsets_ms,
+        label + ": spike offsets after the checkpoint match");
+    check(same_bits(resumed.final_state.V, full.final_state.V), label + ": final V matches");
+    check(same_bits(resumed.final_state.U, full.final_state.U), label + ": final U matches");
+}
+
+std::vector<Scenario> scenarios(std::uint32_t neuron_count, std::uint32_t steps)
+{
+    izhnet::SimulationConfig base;
+    base.sim.steps = steps;
+    base.sim.seed = 7;
+
+    std::vector<Scenario> out;
+    out.push_back(scenario("noise", base, neuron_count));
+    out.back().config.tonic_current = 3.0;
+    out.back().config.noise_stddev = 3.0;
+
+    // Uniform and per-neuron Poisson rates onto a network at rest, with
+    // the active set carried through the checkpoint.
+    out.push_back(resting_scenario("poisson+skip_quiescent", base, neuron_count));
+    out.back().config.poisson_inputs.push_back(poisson_drive(0, neuron_count / 2U, 5.0));
+    izhnet::PoissonInput varied = poisson_drive(neuron_count / 2U, neuron_count - neuron_count / 2U, 0.0);
+    for (std::uint32_t i = 0; i < varied.neuron_count; ++i) {
+        varied.rates_hz.push_back(1.0 + static_cast<double>(i % 10U));
+    }
+    out.back().config.poisson_inputs.push_back(varied);
+
+    // Replayed events on both sides of the checkpoint, including its
+    // own step and the one after it.
+    out.push_back(resting_scenario("spike_train", base, neuron_count));
+    izhnet::SpikeTrainInput train;
+    train.weight = 400.0;
+    for (std::uint32_t step = 0; step < steps; step += 7U) {
+        train.events.push_back(izhnet::SpikeEvent { (step * 31U) % neuron_count, step });
+    }
+    train.events.push_back(izhnet::SpikeEvent { 1U, steps / 2U });
+    train.events.push_back(izhnet::SpikeEvent { 2U, steps / 2U + 1U });
+    out.back().config.spike_train_inputs.push_back(train);
+
+    out.push_back(scenario("rk4", base, neuron_count));
+    out.back().config.tonic_current = 10.0;
+    out.back().config.neuron.integrator = izhnet::Integrator::RK4;
+    return out;
+}
+
+} // namespace
+
+int main()
+{
+    constexpr std::uint32_t neuron_count = 2000;
+    constexpr std::uint32_t steps = 1200;
+    const izhnet::Network network = izhnet::Network::random_fixed_out_degree(neuron_count, 20, 0.1, 3.0, 5, false);
+    const std::filesystem::path dir = "checkpoint_test_data";
+
+    for (const Scenario& scenario : scenarios(neuron_count, steps)) {
+        const std::string final_path = (dir / (scenario.name + ".final.ckpt")).string();
+        const std::string periodic_path = (dir / (scenario.name + ".periodic.ckpt")).string();
+
+        // Uninterrupted run; also leaves the checkpoint of step 900 on disk.
+        izhnet::SimulationConfig full_config = scenario.config;
+        full_config.checkpoint.every_steps = 300;
+        full_config.checkpoint.output_path = periodic_path;
+        const izhnet::SimulationResult full = izhnet::simulate_network(network, scenario.initial, full_config);
+        check(!full.spikes.empty(), scenario.name + ": full run has spikes");
+        check(full.stats.checkpoints_written == 3U, scenario.name + ": three periodic checkpoints written");
+        const bool has_inputs = !scenario.config.poisson_inputs.empty() || !scenario.config.spike_train_inputs.empty();
+        check(!has_inputs || full.stats.input_events > 0, scenario.name + ": inputs delivered");
+        check(!scenario.config.skip_quiescent || full.stats.skipped_neuron_steps > 0, scenario.name + ": neurons skipped");
+
+        // First half, stopped with a final checkpoint kept in memory and on disk.
+        izhnet::SimulationConfig half_config = scenario.config;
+        half_config.sim.steps = steps / 2U;
+        half_config.checkpoint.keep_final = true;
+        half_config.checkpoint.write_final = true;
+        half_config.checkpoint.output_path = final_path;
+        const izhnet::SimulationResult half = izhnet::simulate_network(network, scenario.initial, half_config);
+        check(half.final_checkpoint.has_value(), scenario.name + ": final checkpoint kept");
+        if (!half.final_checkpoint) {
+            continue;
+        }
+        check(half.final_checkpoint->step == steps / 2U, scenario.name + ": checkpoint taken at N/2");
+
+        std::vector<izhnet::SpikeEvent> head = half.spikes;
+        const izhnet::SimulationResult second = izhnet::resume_simulation(network, *half.final_checkpoint, scenario.config);
+        head.insert(head.end(), second.spikes.begin(), second.spikes.end());
+        check(same_spikes(head, full.spikes), scenario.name + ": both halves together match the full run");
+
+        check_resume(scenario.name + " in-memory", network, *half.final_checkpoint, scenario.config, full);
+        check_resume(scenario.name + " from file", network, izhnet::read_checkpoint(final_path), scenario.config, full);
+
+        const izhnet::SimulationCheckpoint periodic = izhnet::read_checkpoint(periodic_path);
+        check(periodic.step == 900U, scenario.name + ": last periodic checkpoint at step 900");
+        check_resume(scenario.name + " periodic", network, periodic, scenario.config, full);
+    }
+
+    // A checkpoint only resumes on the network it was taken on.
+    {
+        izhnet::SimulationConfig config = scenarios(neuron_count, steps).front().config;
+        config.sim.steps = steps / 2U;
+        config.checkpoint.keep_final = true;
+        izhnet::NetworkState initial;
+        izhnet::initial_state(initial, neuron_count);
+        const izhnet::SimulationResult half = izhnet::simulate_network(network, initial, config);
+        check(half.final_checkpoint && half.final_checkpoint->network_fingerprint == network.fingerprint(),
+            "checkpoint records the network fingerprint");
+        config.sim.steps = steps;
+        config.checkpoint.keep_final = false;
+        const izhnet::Network reseeded = izhnet::Network::random_fixed_out_degree(neuron_count, 20, 0.1, 3.0, 6, false);
+        const izhnet::Network reweighted = izhnet::Network::random_fixed_out_degree(neuron_count, 20, 0.1, 3.1, 5, false);
+        for (const izhnet::Network* other : { &reseeded, &reweighted }) {
+            bool rejected = false;
+            try {
+                izhnet::resume_simulation(*other, *half.final_checkpoint, config);
+            } catch (const std::invalid_argument&) {
+                rejected = true;
+            }
+            check(rejected, "resume on a different network is rejected");
+        }
+    }
+
+    // Resuming with another input list restarts the input streams and says so.
+    {
+        izhnet::SimulationConfig config = scenarios(neuron_count, steps)[1].config;
+        config.sim.steps = steps / 2U;
+        config.checkpoint.keep_final = true;
+        izhnet::NetworkState initial;
+        izhnet::initial_state(initial, neuron_count, -70.0, -14.0);
+        const izhnet::SimulationResult half = izhnet::simulate_network(network, initial, config);
+        config.sim.steps = steps;
+        config.checkpoint.keep_final = false;
+        check(!izhnet::resume_simulation(network, *half.final_checkpoint, config).stats.input_reseeded,
+            "same inputs continue their streams");
+        config.poisson_inputs.push_back(poisson_drive(0, 10, 2.0));
+        check(izhnet::resume_simulation(network, *half.final_checkpoint, config).stats.input_reseeded,
+            "an added source restarts the input streams");
+        config.poisson_inputs.pop_back();
+        config.sim.seed += 1U;
+        check(izhnet::resume_simulation(network, *half.final_checkpoint, config).stats.input_reseeded,
+            "another seed restarts the input streams");
+    }
+
+    std::error_code ignored;
+    std::filesystem::remove_all(dir, ignored);
+
+    return finish("resumed runs match the uninterrupted runs");
+}
@@ -0,0 +1,97 @@
+// Every execution plan must reproduce the serial run bit for bit: same
+// spikes in the same order, same final V and U.
+
+#include "izhnet/network/network.hpp"
+#include "izhnet/sim/simulator.hpp"
+#include "test_support.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace izhnet::test;
+
+namespace {
+
+std::string describe(const izhnet::ExecutionPlan& plan)
+{
+    return "update:" + std::to_string(plan.update_threads) + ",chunk:" + std::to_string(plan.chunk) +
+        ",propagation:" + std::to_string(plan.propagation_threads);
+}
+
+std::vector<Scenario> scenarios(std::uint32_t neuron_count)
+{
+    izhnet::SimulationConfig base;
+    base.sim.steps = 400;
+    base.sim.seed = 11;
+    base.sim.omp_threads = 4;
+
+    std::vector<Scenario> out;
+    out.push_back(scenario("tonic", base, neuron_count));
+    out.back().config.tonic_current = 5.0;
+
+    // Starts at rest, so the active set shrinks and regrows with input.
+    out.push_back(resting_scenario("skip_quiescent+poisson", base, neuron_count));
+    out.back().config.poisson_inputs.push_back(poisson_drive(0, neuron_count, 5.0));
+
+    // Noise keeps the update serial; propagation plans still apply.
+    out.push_back(scenario("noise", base, neuron_count));
+    out.back().config.tonic_current = 3.0;
+    out.back().config.noise_stddev = 3.0;
+
+    out.push_back(scenario("rk2", base, neuron_count));
+    out.back().config.tonic_current = 10.0;
+    out.back().config.neuron.integrator = izhnet::Integrator::RK2;
+    return out;
+}
+
+} // namespace
+
+int main()
+{
+    constexpr std::uint32_t neuron_count = 4000;
+    const izhnet::Network network = izhnet::Network::random_fixed_out_degree(neuron_count, 30, 0.1, 3.0, 3, false);
+
+    const std::vector<izhnet::ExecutionPlan> plans {
+        { 1, 0, 0 },
+        { 2, 0, 0 },
+        { 4, 0, 0 },
+        { 4, 256, 0 },
+        { 3, 16, 0 },
+        { 0, 0, 1 },
+        { 0, 0, 3 },
+        { 0, 0, 4 },
+        { 4, 256, 4 },
+        { 2, 0, 3 },
+    };
+
+    for (const Scenario& scenario : scenarios(neuron_count)) {
+        izhnet::SimulationConfig serial = scenario.config;
+        serial.plan = izhnet::ExecutionPlan {};
+        const izhnet::SimulationResult reference = izhnet::simulate_network(network, scenario.initial, serial);
+        check(!reference.spikes.empty(), scenario.name + ": reference run has spikes");
+        check(!scenario.config.skip_quiescent || reference.stats.skipped_neuron_steps > 0,
+            scenario.name + ": reference run skips neurons");
+
+        for (const izhnet::ExecutionPlan& plan : plans) {
+            izhnet::SimulationConfig config = scenario.config;
+            config.plan = plan;
+            const izhnet::SimulationResult result = izhnet::simulate_network(network, scenario.initial, config);
+            const std::string label = scenario.name + " " + describe(plan);
+#if IZHNET_HAS_OPENMP
+            const bool serial_update = scenario.config.noise_stddev > 0.0;
+            check(result.stats.plan.update_threads == (serial_update ? 0 : plan.update_threads) &&
+                    result.stats.plan.chunk == plan.chunk &&
+                    result.stats.plan.propagation_threads == plan.propagation_threads,
+                label + ": plan was applied");
+#endif
+            check(same_spikes(result.spikes, reference.spikes), label + ": spikes match serial");
+            check(result.spike_offsets_ms == reference.spike_offsets_ms, label + ": spike offsets match serial");
+            check(same_bits(result.final_state.V, reference.final_state.V), label + ": V matches serial");
+            check(same_bits(result.final_state.U, reference.final_state.U), label + ": U matches serial");
+            check(result.stats.skipped_neuron_steps == reference.stats.skipped_neuron_steps,
+                label + ": skipped neuron steps match serial");
+        }
+    }
+
+    return finish("all execution plans match the serial run");
+}
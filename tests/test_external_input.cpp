@@ -0,0 +1,226 @@
+// External input generators: Poisson sources deliver about rate * N * T
+// events, only onto their own neurons, and replayed CSV or archive spikes
+// land on the step nearest their time.
+
+#include "izhnet/io/spike_archive.hpp"
+#include "izhnet/io/spike_logger.hpp"
+#include "izhnet/sim/external_input.hpp"
+#include "test_support.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace izhnet::test;
+
+namespace {
+
+constexpr std::uint32_t kNetworkSize = 1000;
+constexpr double kDt = 0.1;
+
+struct Delivered {
+    std::vector<double> events_per_neuron; // current / weight, i.e. event counts
+    std::uint64_t events = 0;
+    bool outside = false; // an event hit a neuron outside the source range
+};
+
+// Runs one source for `steps` steps. Weights are 1, so a delivered current
+// is the number of events in that cell.
+Delivered run_poisson(const izhnet::PoissonInput& input, std::uint32_t steps)
+{
+    izhnet::ExternalInput external({ input }, {}, kNetworkSize, kDt, 17);
+    Delivered out;
+    out.events_per_neuron.assign(kNetworkSize, 0.0);
+    for (std::uint32_t step = 0; step < steps; ++step) {
+        external.deliver(step, [&](std::uint32_t target, double current) {
+            if (target < input.first_neuron || target >= input.first_neuron + input.neuron_count) {
+                out.outside = true;
+                return;
+            }
+            out.events_per_neuron[target] += current;
+        });
+    }
+    out.events = external.events_delivered();
+    return out;
+}
+
+// |observed - expected| within k standard deviations of a Poisson count.
+bool near_poisson(double observed, double expected, double k)
+{
+    return std::abs(observed - expected) <= k * std::sqrt(expected);
+}
+
+std::vector<std::pair<std::uint32_t, std::uint32_t>> replay(
+    const izhnet::SpikeTrainInput& train,
+    std::uint32_t steps,
+    std::uint32_t first_step = 0)
+{
+    izhnet::ExternalInput external({}, { train }, kNetworkSize, kDt, 17, first_step);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> out; // (step, target)
+    for (std::uint32_t step = first_step; step < steps; ++step) {
+        external.deliver(step, [&](std::uint32_t target, double current) {
+            out.emplace_back(step, target);
+            check(current == train.weight, "replayed event carries the train weight");
+        });
+    }
+    return out;
+}
+
+} // namespace
+
+int main()
+{
+    constexpr std::uint32_t steps = 20000; // 2 s
+    const double seconds = steps * kDt * 1e-3;
+
+    // Uniform rate on a sub-range, including a rate high enough that cells
+    // with two or more events occur.
+    for (const double rate_hz : { 20.0, 800.0 }) {
+        const std::string label = "uniform " + std::to_string(rate_hz) + " Hz";
+        izhnet::PoissonInput input;
+        input.first_neuron = 200;
+        input.neuron_count = 500;
+        input.rate_hz = rate_hz;
+        input.weight = 1.0;
+        const Delivered d = run_poisson(input, steps);
+        const double expected = rate_hz * input.neuron_count * seconds;
+        check(!d.outside, label + ": events stay inside the source range");
+        check(near_poisson(static_cast<double>(d.events), expected, 5.0), label + ": about rate * N * T events");
+        double total = 0.0;
+        bool every_neuron = true;
+        for (std::uint32_t i = input.first_neuron; i < input.first_neuron + input.neuron_count; ++i) {
+            total += d.events_per_neuron[i];
+            every_neuron = every_neuron && near_poisson(d.events_per_neuron[i], rate_hz * seconds, 6.0);
+        }
+        check(total == static_cast<double>(d.events), label + ": delivered current matches the event count");
+        check(every_neuron, label + ": every neuron gets about rate * T events");
+    }
+
+    // Per-neuron rates: each rate class gets its own share.
+    {
+        izhnet::PoissonInput input;
+        input.first_neuron = 600;
+        input.neuron_count = 400;
+        input.weight = 1.0;
+        for (std::uint32_t i = 0; i < input.neuron_count; ++i) {
+            input.rates_hz.push_back(i % 4U == 3U ? 0.0 : 5.0 * static_cast<double>(1U + i % 4U));
+        }
+        const Delivered d = run_poisson(input, steps);
+        check(!d.outside, "per-neuron rates: events stay inside the source range");
+        double expected_total = 0.0;
+        for (std::uint32_t rate_class = 0; rate_class < 4U; ++rate_class) {
+            double observed = 0.0;
+            double expected = 0.0;
+            for (std::uint32_t i = rate_class; i < input.neuron_count; i += 4U) {
+                observed += d.events_per_neuron[input.first_neuron + i];
+                expected += input.rates_hz[i] * seconds;
+            }
+            expected_total += expected;
+            check(expected > 0.0 ? near_poisson(observed, expected, 5.0) : observed == 0.0,
+                "per-neuron rates: class " + std::to_string(rate_class) + " gets its rate");
+        }
+        check(near_poisson(static_cast<double>(d.events), expected_total, 5.0),
+            "per-neuron rates: about sum(rate) * T events");
+    }
+
+    // Per-neuron weights scale each neuron's current.
+    {
+        izhnet::PoissonInput input;
+        input.first_neuron = 10;
+        input.neuron_count = 3;
+        input.rate_hz = 200.0;
+        input.weights = { 1.0, 10.0, 100.0 };
+        izhnet::ExternalInput external({ input }, {}, kNetworkSize, kDt, 17);
+        bool scaled = true;
+        for (std::uint32_t step = 0; step < 2000; ++step) {
+            external.deliver(step, [&](std::uint32_t target, double current) {
+                const double weight = input.weights[target - input.first_neuron];
+                scaled = scaled && current / weight == std::floor(current / weight) && current >= weight;
+            });
+        }
+        check(scaled && external.events_delivered() > 0, "per-neuron weights scale the delivered current");
+    }
+
+    bool rejected = false;
+    try {
+        izhnet::PoissonInput outside;
+        outside.first_neuron = kNetworkSize - 10U;
+        outside.neuron_count = 11;
+        outside.rate_hz = 1.0;
+        izhnet::ExternalInput external({ outside }, {}, kNetworkSize, kDt, 17);
+    } catch (const std::out_of_range&) {
+        rejected = true;
+    }
+    check(rejected, "a source reaching past the network is rejected");
+
+    const std::filesystem::path dir = "external_input_test_data";
+    std::filesystem::create_directories(dir);
+
+    // Hand-written CSV: times map to the nearest step, in any order, and
+    // the header line is skipped.
+    {
+        const std::string path = (dir / "train.csv").string();
+        {
+            std::ofstream out(path);
+            out << "time_ms,neuron_id\n"
+                << "1.04,5\n"    // step 10
+                << "0,3\n"       // step 0
+                << "0.26,4\n"    // step 3
+                << "1.04,2\n"    // step 10, after neuron 5 in file order
+                << "99.96,999\n"; // step 1000
+        }
+        const izhnet::SpikeTrainInput train = izhnet::load_spike_train(path, kDt, 2.5);
+        const std::vector<std::pair<std::uint32_t, std::uint32_t>> expected {
+            { 0, 3 }, { 3, 4 }, { 10, 5 }, { 10, 2 }, { 1000, 999 },
+        };
+        check(replay(train, 1001) == expected, "CSV replay lands on the nearest steps");
+        const std::vector<std::pair<std::uint32_t, std::uint32_t>> tail { { 10, 5 }, { 10, 2 }, { 1000, 999 } };
+        check(replay(train, 1001, 10) == tail, "CSV replay from a later first step skips earlier events");
+
+        // At a coarser dt the same times collapse onto fewer steps.
+        const izhnet::SpikeTrainInput coarse = izhnet::load_spike_train(path, 0.5, 1.0);
+        check(coarse.events.size() == 5U && coarse.events[0].step == 2U && coarse.events[2].step == 1U &&
+                coarse.events[4].step == 200U,
+            "CSV times map to the nearest step of the loading dt");
+    }
+
+    // A logged run (time,neuron,step with sub-step offsets) and its archive
+    // replay onto the same steps.
+    {
+        const std::vector<izhnet::SpikeEvent> spikes {
+            { 1, 0 }, { 7, 4 }, { 2, 4 }, { 900, 30 }, { 0, 31 },
+        };
+        const std::vector<float> offsets { 0.01F, 0.02F, 0.07F, 0.0F, 0.049F };
+        // Offsets below half a step stay on their step; above, the next.
+        const std::vector<std::pair<std::uint32_t, std::uint32_t>> expected {
+            { 0, 1 }, { 4, 7 }, { 5, 2 }, { 30, 900 }, { 31, 0 },
+        };
+
+        const std::string csv = (dir / "logged.csv").string();
+        izhnet::write_spikes_csv(csv, spikes, kDt, true, offsets);
+        check(replay(izhnet::load_spike_train(csv, kDt, 1.0), 40) == expected, "logged CSV replays onto its steps");
+
+        const std::string archive = (dir / "logged.izsa").string();
+        izhnet::write_spike_archive(archive, spikes, kNetworkSize, 40, kDt, {}, offsets);
+        check(replay(izhnet::load_spike_train(archive, kDt, 1.0), 40) == expected, ".izsa replay lands on its steps");
+
+        // Without offsets, archive steps scale by the ratio of the two dts.
+        izhnet::write_spike_archive(archive, spikes, kNetworkSize, 40, 0.5);
+        const izhnet::SpikeTrainInput rescaled = izhnet::load_spike_train(archive, kDt, 1.0);
+        bool scaled = rescaled.events.size() == spikes.size();
+        for (const izhnet::SpikeEvent& event : rescaled.events) {
+            scaled = scaled && event.step % 5U == 0U;
+        }
+        check(scaled && replay(rescaled, 200).back() == std::pair<std::uint32_t, std::uint32_t> { 155, 0 },
+            ".izsa replay at a finer dt scales the steps");
+    }
+
+    std::error_code ignored;
+    std::filesystem::remove_all(dir, ignored);
+    return finish("external inputs deliver the expected events");
+}
@@ -0,0 +1,107 @@
+// Quiescent skipping against full integration: the same network, drive and
+// seed must spike identically, and the traced V and U of skipped runs stay
+// within the bound documented on SimulationConfig::skip_quiescent.
+
+#include "izhnet/io/trace_recorder.hpp"
+#include "izhnet/network/network.hpp"
+#include "izhnet/sim/simulator.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace izhnet::test;
+
+namespace {
+
+// Subthreshold: both runs below -60 mV, away from the spike upstroke.
+constexpr double kSubthresholdMv = -60.0;
+
+struct Deviation {
+    double V = 0.0;
+    double V_subthreshold = 0.0;
+    double U = 0.0;
+};
+
+Deviation max_deviation(const izhnet::TraceData& lhs, const izhnet::TraceData& rhs)
+{
+    Deviation out;
+    for (std::size_t i = 0; i < lhs.V.size(); ++i) {
+        const double dV = std::abs(lhs.V[i] - rhs.V[i]);
+        out.V = std::max(out.V, dV);
+        if (std::max(lhs.V[i], rhs.V[i]) < kSubthresholdMv) {
+            out.V_subthreshold = std::max(out.V_subthreshold, dV);
+        }
+        out.U = std::max(out.U, std::abs(lhs.U[i] - rhs.U[i]));
+    }
+    return out;
+}
+
+double max_offset_deviation(const std::vector<float>& lhs, const std::vector<float>& rhs)
+{
+    double out = 0.0;
+    for (std::size_t i = 0; i < std::min(lhs.size(), rhs.size()); ++i) {
+        out = std::max(out, static_cast<double>(std::abs(lhs[i] - rhs[i])));
+    }
+    return out;
+}
+
+} // namespace
+
+int main()
+{
+    constexpr std::uint32_t neuron_count = 3000;
+    const izhnet::Network network = izhnet::Network::random_fixed_out_degree(neuron_count, 20, 0.1, 3.0, 5, false);
+    const std::filesystem::path dir = "quiescent_test_data";
+    std::filesystem::create_directories(dir);
+
+    izhnet::SimulationConfig base;
+    base.sim.steps = 2000;
+    base.sim.seed = 3;
+    for (std::uint32_t i = 0; i < neuron_count; i += 10U) {
+        base.trace.neurons.push_back(i);
+    }
+
+    for (const izhnet::Integrator integrator : { izhnet::Integrator::Euler, izhnet::Integrator::RK4 }) {
+        for (const double tolerance : { 1e-4, 1e-6 }) {
+            Scenario s = resting_scenario("", base, neuron_count);
+            s.config.neuron.V_min = -100.0;
+            s.config.neuron.integrator = integrator;
+            s.config.quiescent_tolerance = tolerance;
+            s.config.poisson_inputs.push_back(poisson_drive(0, neuron_count, 5.0));
+            const std::string label = std::string(integrator == izhnet::Integrator::Euler ? "euler" : "rk4") +
+                " tol " + std::to_string(tolerance);
+
+            izhnet::SimulationConfig full_config = s.config;
+            full_config.skip_quiescent = false;
+            full_config.trace.output_path = (dir / "full.trace").string();
+            const izhnet::SimulationResult full = izhnet::simulate_network(network, s.initial, full_config);
+
+            izhnet::SimulationConfig skip_config = s.config;
+            skip_config.trace.output_path = (dir / "skip.trace").string();
+            const izhnet::SimulationResult skipped = izhnet::simulate_network(network, s.initial, skip_config);
+
+            check(!full.spikes.empty(), label + ": full run has spikes");
+            check(skipped.stats.skipped_neuron_steps > 0, label + ": neurons skipped");
+            check(same_spikes(skipped.spikes, full.spikes), label + ": spikes match full integration");
+            check(skipped.spike_offsets_ms.size() == full.spike_offsets_ms.size() &&
+                    max_offset_deviation(skipped.spike_offsets_ms, full.spike_offsets_ms) <= 1e-3 * base.sim.dt_ms,
+                label + ": spike offsets match full integration");
+
+            const Deviation d = max_deviation(
+                izhnet::read_trace_file(full_config.trace.output_path),
+                izhnet::read_trace_file(skip_config.trace.output_path));
+            check(d.U <= 2.0 * tolerance, label + ": max |dU| = " + std::to_string(d.U / tolerance) + " tol");
+            check(d.V_subthreshold <= 3.0 * tolerance,
+                label + ": max subthreshold |dV| = " + std::to_string(d.V_subthreshold / tolerance) + " tol");
+            check(d.V <= 20.0 * tolerance, label + ": max |dV| = " + std::to_string(d.V / tolerance) + " tol");
+        }
+    }
+
+    std::error_code ignored;
+    std::filesystem::remove_all(dir, ignored);
+    return finish("quiescent skipping matches full integration");
+}
@@ -0,0 +1,198 @@
+// Raster binning against a brute-force histogram of the same spikes, for a
+// known neuron count and for the fold-rows path that grows the row span as
+// larger ids appear, across chunk sizes and thread counts.
+
+#include "izhnet/io/raster_renderer.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace izhnet::test;
+
+namespace {
+
+struct Spike {
+    double time_ms;
+    std::uint32_t neuron_id;
+};
+
+// Written in time order, like a simulation log; times are multiples of
+// 1/8 ms so they print exactly.
+void write_csv(const std::string& path, std::vector<Spike> spikes)
+{
+    std::stable_sort(spikes.begin(), spikes.end(),
+        [](const Spike& lhs, const Spike& rhs) { return lhs.time_ms < rhs.time_ms; });
+    std::ofstream out(path, std::ios::trunc);
+    out << "time_ms,neuron_id,step\n";
+    for (const Spike& spike : spikes) {
+        out << spike.time_ms << ',' << spike.neuron_id << ',' << static_cast<std::uint32_t>(spike.time_ms * 8.0) << '\n';
+    }
+}
+
+struct Expected {
+    std::vector<std::uint64_t> counts; // rows_used x width, row 0 = lowest ids
+    std::vector<std::uint64_t> column_spikes;
+    std::uint64_t binned = 0;
+    std::uint32_t rows_used = 0;
+};
+
+Expected brute_force(
+    const std::vector<Spike>& spikes,
+    const izhnet::RasterOptions& options,
+    double end_ms,
+    std::uint64_t span,
+    std::uint32_t neuron_count)
+{
+    Expected out;
+    out.rows_used = static_cast<std::uint32_t>(
+        std::clamp<std::uint64_t>((neuron_count + span - 1U) / span, 1U, options.height));
+    out.counts.assign(static_cast<std::size_t>(options.height) * options.width, 0U);
+    out.column_spikes.assign(options.width, 0U);
+    const double cols_per_ms = options.width / (end_ms - options.start_ms);
+    for (const Spike& spike : spikes) {
+        if (spike.time_ms < options.start_ms || spike.time_ms > end_ms || spike.neuron_id >= neuron_count) {
+            continue;
+        }
+        const auto col = std::min(options.width - 1U,
+            static_cast<std::uint32_t>((spike.time_ms - options.start_ms) * cols_per_ms));
+        ++out.counts[static_cast<std::size_t>(spike.neuron_id / span) * options.width + col];
+        ++out.column_spikes[col];
+        ++out.binned;
+    }
+    return out;
+}
+
+// Compares the raster panel pixel by pixel (inked or blank, and darkest at
+// the peak count) and the rate bars with the brute-force histogram.
+void check_image(const std::string& label, const izhnet::RasterImage& image, const izhnet::RasterOptions& options,
+    const Expected& expected)
+{
+    const std::uint64_t peak = *std::max_element(expected.counts.begin(), expected.counts.end());
+    bool panel = true;
+    bool darkest = false;
+    for (std::uint32_t y = 0; y < options.height; ++y) {
+        const std::size_t row = static_cast<std::size_t>(options.height - 1U - y) * expected.rows_used / options.height;
+        for (std::uint32_t x = 0; x < options.width; ++x) {
+            const std::uint64_t c = expected.counts[row * options.width + x];
+            const std::uint8_t red = image.rgb[(static_cast<std::size_t>(y) * image.width + x) * 3U];
+            panel = panel && ((c == 0) == (red == 255U));
+            darkest = darkest || (c == peak && red == 16U);
+        }
+    }
+    check(panel, label + ": inked pixels are exactly the non-empty bins");
+    check(darkest, label + ": the peak bin has the darkest ink");
+
+    if (options.rate_height > 0) {
+        const std::uint64_t peak_column = *std::max_element(expected.column_spikes.begin(), expected.column_spikes.end());
+        const std::uint32_t base = image.height - 1U;
+        bool bars = true;
+        for (std::uint32_t x = 0; x < options.width; ++x) {
+            const auto bar = static_cast<std::uint32_t>(std::lround(static_cast<double>(expected.column_spikes[x]) /
+                static_cast<double>(peak_column) * static_cast<double>(options.rate_height - 1U)));
+            for (std::uint32_t h = 0; h < options.rate_height; ++h) {
+                const bool red = image.rgb[(static_cast<std::size_t>(base - h) * image.width + x) * 3U + 1U] == 40U;
+                bars = bars && (red == (expected.column_spikes[x] > 0 && h <= bar));
+            }
+        }
+        check(bars, label + ": rate bars follow the column spike counts");
+    }
+}
+
+} // namespace
+
+int main()
+{
+    const std::filesystem::path dir = "raster_test_data";
+    std::filesystem::create_directories(dir);
+
+    // Hand-placed spikes on a 10 x 4 grid, two neurons per row.
+    {
+        const std::string path = (dir / "small.csv").string();
+        const std::vector<Spike> spikes {
+            { 0.0, 0 }, { 0.5, 1 }, { 0.875, 1 }, // column 0, row 0: three spikes
+            { 3.25, 2 }, { 3.75, 5 },             // column 3, rows 1 and 2
+            { 9.875, 7 }, { 10.0, 6 },            // the end time falls in the last column
+            { 10.5, 0 },                          // after end_ms: skipped
+            { 4.0, 8 },                           // past neuron_count: skipped
+        };
+        write_csv(path, spikes);
+        izhnet::RasterOptions options;
+        options.width = 10;
+        options.height = 4;
+        options.rate_height = 6;
+        options.end_ms = 10.0;
+        options.neuron_count = 8;
+        izhnet::RasterImage image;
+        const izhnet::RasterSummary summary = izhnet::render_spike_raster(path, options, image);
+        check(summary.events_binned == 7U && summary.events_skipped == 2U, "small: binned and skipped counts");
+        check(summary.neurons_per_row == 2U && summary.neuron_count == 8U, "small: two neurons per row");
+        check(image.width == 10U && image.height == 4U + 1U + 6U, "small: image size");
+        // Three spikes in a 1 ms bin across 8 neurons.
+        check(std::abs(summary.peak_rate_hz - 3.0 / (8.0 * 1e-3)) < 1e-9, "small: peak rate");
+        check_image("small", image, options, brute_force(spikes, options, 10.0, 2, 8));
+
+        // Without an end time the raster ends at the latest spike.
+        options.end_ms = -1.0;
+        check(izhnet::render_spike_raster(path, options, image).end_ms == 10.5, "small: end time from the file");
+    }
+
+    // Random spikes over a growing id range, rendered with an unknown neuron
+    // count (rows fold as ids grow) and with the count given up front. Both
+    // land on the same span, so the images must be identical.
+    {
+        const std::string path = (dir / "random.csv").string();
+        std::mt19937_64 rng(5);
+        std::vector<Spike> spikes;
+        constexpr std::uint32_t neuron_count = 1000; // span 8 at height 128
+        for (std::uint32_t step = 0; step < 4000; ++step) {
+            // Ids start small and reach the full range late, so tiles fold
+            // at different points in the file.
+            const std::uint32_t id_limit = std::min<std::uint32_t>(neuron_count, 4U + step / 3U);
+            if (rng() % 3U == 0U) {
+                spikes.push_back({ step * 0.125, static_cast<std::uint32_t>(rng() % id_limit) });
+            }
+        }
+        spikes.push_back({ 499.875, neuron_count - 1U });
+        write_csv(path, spikes);
+
+        izhnet::RasterOptions options;
+        options.width = 50;
+        options.height = 128;
+        options.rate_height = 20;
+        const Expected expected = brute_force(spikes, options, 499.875, 8, neuron_count);
+
+        izhnet::RasterImage reference;
+        izhnet::RasterOptions known = options;
+        known.neuron_count = neuron_count;
+        const izhnet::RasterSummary fixed = izhnet::render_spike_raster(path, known, reference);
+        check(fixed.neurons_per_row == 8U && fixed.events_binned == expected.binned, "random known count: span and binned");
+        check_image("random known count", reference, options, expected);
+
+        for (const int threads : { 1, 3 }) {
+            for (const std::size_t chunk_bytes : { std::size_t { 4096 }, std::size_t { 1 } << 20U }) {
+                const std::string label = "folded, " + std::to_string(threads) + " threads, chunk " +
+                    std::to_string(chunk_bytes);
+                izhnet::RasterOptions folded = options;
+                folded.threads = threads;
+                folded.chunk_bytes = chunk_bytes;
+                izhnet::RasterImage image;
+                const izhnet::RasterSummary summary = izhnet::render_spike_raster(path, folded, image);
+                check(summary.neurons_per_row == 8U && summary.neuron_count == neuron_count,
+                    label + ": rows folded to the final span");
+                check(summary.events_binned == expected.binned && summary.events_skipped == 0U, label + ": binned");
+                check(image.rgb == reference.rgb, label + ": image matches the known-count render");
+            }
+        }
+    }
+
+    std::error_code ignored;
+    std::filesystem::remove_all(dir, ignored);
+    return finish("raster bins match a brute-force histogram");
+}
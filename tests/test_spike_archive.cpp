@@ -0,0 +1,300 @@
+// Spike archive queries against a brute-force filter of the written spikes,
+// with and without the neuron index and the offset column, and rejection of
+// truncated or corrupt files on open.
+
+#include "izhnet/io/spike_archive.hpp"
+#include "test_support.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace izhnet::test;
+
+namespace {
+
+constexpr std::uint32_t kNeurons = 300;
+constexpr std::uint32_t kSteps = 1000;
+constexpr double kDt = 0.1;
+
+// Header fields the corruption cases patch (see spike_archive.hpp).
+constexpr std::size_t kStepIndexOffsetAt = 48;
+constexpr std::size_t kNeuronIndexOffsetAt = 56;
+
+struct Spikes {
+    std::vector<izhnet::SpikeEvent> events; // shuffled, so the writer sorts
+    std::vector<float> offsets_ms;          // parallel to events
+};
+
+Spikes make_spikes()
+{
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<float> offset(0.0F, static_cast<float>(kDt));
+    Spikes out;
+    for (std::uint32_t step = 0; step < kSteps; ++step) {
+        // Gaps of empty steps, bursts, and a silent last block.
+        if (step % 97U < 11U || step >= kSteps - 40U) {
+            continue;
+        }
+        for (std::uint32_t neuron = 0; neuron < kNeurons; ++neuron) {
+            if (rng() % 53U == 0U || (neuron == 7U && step % 3U == 0U)) {
+                out.events.push_back(izhnet::SpikeEvent { neuron, step });
+                out.offsets_ms.push_back(offset(rng));
+            }
+        }
+    }
+    std::vector<std::size_t> order(out.events.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), rng);
+    Spikes shuffled;
+    for (const std::size_t i : order) {
+        shuffled.events.push_back(out.events[i]);
+        shuffled.offsets_ms.push_back(out.offsets_ms[i]);
+    }
+    return shuffled;
+}
+
+// Spikes in archive order: by step, then neuron.
+Spikes sorted(const Spikes& spikes)
+{
+    std::vector<std::size_t> order(spikes.events.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+        const izhnet::SpikeEvent& a = spikes.events[lhs];
+        const izhnet::SpikeEvent& b = spikes.events[rhs];
+        return a.step < b.step || (a.step == b.step && a.neuron_id < b.neuron_id);
+    });
+    Spikes out;
+    for (const std::size_t i : order) {
+        out.events.push_back(spikes.events[i]);
+        out.offsets_ms.push_back(spikes.offsets_ms[i]);
+    }
+    return out;
+}
+
+Spikes brute_steps(const Spikes& reference, std::uint32_t step_begin, std::uint32_t step_end)
+{
+    Spikes out;
+    for (std::size_t i = 0; i < reference.events.size(); ++i) {
+        if (reference.events[i].step >= step_begin && reference.events[i].step < step_end) {
+            out.events.push_back(reference.events[i]);
+            out.offsets_ms.push_back(reference.offsets_ms[i]);
+        }
+    }
+    return out;
+}
+
+Spikes brute_neurons(
+    const Spikes& reference,
+    const std::vector<std::uint32_t>& ids,
+    std::uint32_t step_begin,
+    std::uint32_t step_end)
+{
+    Spikes out;
+    for (const std::uint32_t id : ids) {
+        for (std::size_t i = 0; i < reference.events.size(); ++i) {
+            const izhnet::SpikeEvent& event = reference.events[i];
+            if (event.neuron_id == id && event.step >= step_begin && event.step < step_end) {
+                out.events.push_back(event);
+                out.offsets_ms.push_back(reference.offsets_ms[i]);
+            }
+        }
+    }
+    return out;
+}
+
+void check_span(
+    const std::string& label,
+    const izhnet::SpikeArchive& archive,
+    std::span<const izhnet::SpikeEvent> records,
+    const Spikes& expected)
+{
+    check(same_spikes(std::vector<izhnet::SpikeEvent>(records.begin(), records.end()), expected.events),
+        label + ": spikes match");
+    const std::span<const float> offsets = archive.offsets_ms(records);
+    if (archive.info().has_offsets) {
+        check(std::vector<float>(offsets.begin(), offsets.end()) == expected.offsets_ms, label + ": offsets match");
+    } else {
+        check(offsets.empty(), label + ": no offsets stored");
+    }
+}
+
+std::vector<char> read_bytes(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void write_bytes(const std::string& path, const std::vector<char>& bytes)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+template <class T>
+T field(const std::vector<char>& bytes, std::size_t at)
+{
+    T value {};
+    std::memcpy(&value, bytes.data() + at, sizeof(T));
+    return value;
+}
+
+template <class T>
+void set_field(std::vector<char>& bytes, std::size_t at, T value)
+{
+    std::memcpy(bytes.data() + at, &value, sizeof(T));
+}
+
+bool rejected(const std::string& path)
+{
+    try {
+        izhnet::SpikeArchive archive(path);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int main()
+{
+    const std::filesystem::path dir = "spike_archive_test_data";
+    const Spikes spikes = make_spikes();
+    const Spikes reference = sorted(spikes);
+
+    struct Ranges {
+        std::uint32_t begin;
+        std::uint32_t end;
+    };
+    const std::vector<Ranges> ranges {
+        { 0, kSteps },
+        { 0, 0 },
+        { 500, 500 },
+        { 600, 400 },
+        { 0, 1 },
+        { 63, 65 },
+        { 97, 108 },     // empty steps only
+        { 960, kSteps }, // silent tail
+        { 123, 777 },
+        { 900, 5000 },   // past step_count
+        { kSteps, kSteps + 10 },
+    };
+    const std::vector<std::vector<std::uint32_t>> id_sets {
+        {},
+        { 7 },
+        { 3, 3, 17, 0, kNeurons - 1U },
+        { 7, 250, 7 },
+    };
+
+    for (const bool neuron_index : { false, true }) {
+        for (const bool offsets : { false, true }) {
+            for (const std::uint32_t stride : { 64U, 7U }) {
+                const std::string label = std::string(neuron_index ? "indexed" : "plain") +
+                    (offsets ? "+offsets" : "") + " stride " + std::to_string(stride);
+                const std::string path = (dir / "spikes.izsa").string();
+                izhnet::SpikeArchiveOptions options;
+                options.neuron_index = neuron_index;
+                options.index_stride_steps = stride;
+                izhnet::write_spike_archive(path, spikes.events, kNeurons, kSteps, kDt, options,
+                    offsets ? std::span<const float>(spikes.offsets_ms) : std::span<const float> {});
+
+                const izhnet::SpikeArchive archive(path);
+                check(archive.info().spike_count == reference.events.size(), label + ": spike count");
+                check(archive.info().has_neuron_index == neuron_index, label + ": neuron index flag");
+                check(archive.info().has_offsets == offsets, label + ": offsets flag");
+
+                for (const Ranges& r : ranges) {
+                    const std::string range = label + " [" + std::to_string(r.begin) + ", " + std::to_string(r.end) + ")";
+                    check_span(range + " steps", archive, archive.steps(r.begin, r.end),
+                        brute_steps(reference, r.begin, r.end));
+                    // Step times computed the way a caller would print them.
+                    const double t0 = static_cast<double>(r.begin) * kDt;
+                    const double t1 = static_cast<double>(r.end) * kDt;
+                    check_span(range + " window", archive, archive.window(t0, t1),
+                        brute_steps(reference, r.begin, r.end));
+                    check_span(range + " mid-step window", archive, archive.window(t0 - 0.5 * kDt, t1 - 0.5 * kDt),
+                        brute_steps(reference, r.begin, r.end));
+
+                    for (const std::vector<std::uint32_t>& ids : id_sets) {
+                        std::vector<float> got_offsets;
+                        const std::vector<izhnet::SpikeEvent> got = archive.neurons(ids, r.begin, r.end, &got_offsets);
+                        const Spikes expected = brute_neurons(reference, ids, r.begin, r.end);
+                        check(same_spikes(got, expected.events), range + " neurons: spikes match");
+                        check(offsets ? got_offsets == expected.offsets_ms : got_offsets.empty(),
+                            range + " neurons: offsets match");
+                    }
+                }
+
+                bool out_of_range = false;
+                try {
+                    archive.neurons({ kNeurons });
+                } catch (const std::out_of_range&) {
+                    out_of_range = true;
+                }
+                check(out_of_range, label + ": unknown neuron id rejected");
+            }
+        }
+    }
+
+    // Truncation anywhere past the header, and indexes that point outside
+    // the records, are rejected on open.
+    for (const bool neuron_index : { false, true }) {
+        for (const bool offsets : { false, true }) {
+            const std::string label = std::string(neuron_index ? "indexed" : "plain") + (offsets ? "+offsets" : "");
+            const std::string path = (dir / "source.izsa").string();
+            const std::string damaged = (dir / "damaged.izsa").string();
+            izhnet::SpikeArchiveOptions options;
+            options.neuron_index = neuron_index;
+            izhnet::write_spike_archive(path, spikes.events, kNeurons, kSteps, kDt, options,
+                offsets ? std::span<const float>(spikes.offsets_ms) : std::span<const float> {});
+            const std::vector<char> bytes = read_bytes(path);
+
+            for (const std::size_t cut : { std::size_t { 4 }, std::size_t { 4096 }, bytes.size() - 10U }) {
+                write_bytes(damaged, std::vector<char>(bytes.begin(), bytes.end() - static_cast<std::ptrdiff_t>(cut)));
+                check(rejected(damaged), label + ": truncated by " + std::to_string(cut) + " bytes rejected");
+            }
+
+            const std::size_t step_index = field<std::uint64_t>(bytes, kStepIndexOffsetAt);
+            std::vector<char> corrupt = bytes;
+            set_field<std::uint64_t>(corrupt, step_index + 2U * sizeof(std::uint64_t), spikes.events.size() + 1U);
+            write_bytes(damaged, corrupt);
+            check(rejected(damaged), label + ": step index past the records rejected");
+
+            corrupt = bytes;
+            set_field<std::uint64_t>(corrupt, kStepIndexOffsetAt, step_index + 8U);
+            write_bytes(damaged, corrupt);
+            check(rejected(damaged), label + ": misplaced step index rejected");
+
+            if (neuron_index) {
+                const std::size_t neuron_index_at = field<std::uint64_t>(bytes, kNeuronIndexOffsetAt);
+                corrupt = bytes;
+                set_field<std::uint64_t>(corrupt, neuron_index_at + 10U * sizeof(std::uint64_t), 0U);
+                write_bytes(damaged, corrupt);
+                check(rejected(damaged), label + ": non-monotone neuron index rejected");
+
+                corrupt = bytes;
+                set_field<std::uint64_t>(corrupt, neuron_index_at + kNeurons * sizeof(std::uint64_t),
+                    spikes.events.size() - 1U);
+                write_bytes(damaged, corrupt);
+                check(rejected(damaged), label + ": neuron index not ending at the spike count rejected");
+            }
+        }
+    }
+
+    std::error_code ignored;
+    std::filesystem::remove_all(dir, ignored);
+    return finish("spike archive queries match a brute-force filter");
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+// Shared scaffolding for the test executables: a failure counter, bitwise
+// comparisons and the scenario fixtures several tests run on.
+
+#include "izhnet/sim/simulator.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace izhnet::test {
+
+inline int failures = 0;
+
+inline void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+        ++failures;
+    }
+}
+
+// Exit code for main(): prints the failure count or the success message.
+inline int finish(const char* success)
+{
+    if (failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("%s\n", success);
+    return 0;
+}
+
+inline bool same_bits(const AlignedVector<double>& lhs, const AlignedVector<double>& rhs)
+{
+    return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(double)) == 0;
+}
+
+inline bool same_spikes(const std::vector<SpikeEvent>& lhs, const std::vector<SpikeEvent>& rhs)
+{
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        if (lhs[i].neuron_id != rhs[i].neuron_id || lhs[i].step != rhs[i].step) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Spikes from step first_step on.
+inline std::vector<SpikeEvent> tail(const std::vector<SpikeEvent>& spikes, std::uint32_t first_step)
+{
+    std::vector<SpikeEvent> out;
+    for (const SpikeEvent& event : spikes) {
+        if (event.step >= first_step) {
+            out.push_back(event);
+        }
+    }
+    return out;
+}
+
+struct Scenario {
+    std::string name;
+    SimulationConfig config;
+    NetworkState initial;
+};
+
+// Default initial state.
+inline Scenario scenario(const std::string& name, const SimulationConfig& base, std::size_t neuron_count)
+{
+    Scenario s { name, base, {} };
+    initial_state(s.initial, neuron_count);
+    return s;
+}
+
+// Starts every neuron at rest with V_min lowered, so quiescent skipping
+// applies until input arrives.
+inline Scenario resting_scenario(const std::string& name, const SimulationConfig& base, std::size_t neuron_count)
+{
+    Scenario s { name, base, {} };
+    s.config.neuron.V_min = std::numeric_limits<double>::lowest();
+    s.config.skip_quiescent = true;
+    s.config.quiescent_tolerance = 1e-3;
+    initial_state(s.initial, neuron_count, -70.0, -14.0);
+    return s;
+}
+
+// A Poisson source strong enough that each event makes its target spike.
+inline PoissonInput poisson_drive(std::uint32_t first_neuron, std::uint32_t neuron_count, double rate_hz)
+{
+    PoissonInput drive;
+    drive.first_neuron = first_neuron;
+    drive.neuron_count = neuron_count;
+    drive.rate_hz = rate_hz;
+    drive.weight = 400.0;
+    return drive;
+}
+
+} // namespace izhnet::test
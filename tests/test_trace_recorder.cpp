@@ -0,0 +1,180 @@
+// Trace files read back through read_trace_file: every recorded sample of
+// every traced neuron, across blocks that wrap around the preallocated
+// ring, with decimation, and from a simulation run.
+
+#include "izhnet/io/trace_recorder.hpp"
+#include "izhnet/network/network.hpp"
+#include "izhnet/sim/simulator.hpp"
+#include "test_support.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace izhnet::test;
+
+namespace {
+
+constexpr std::uint32_t kNetworkSize = 50;
+constexpr double kDt = 0.25;
+
+double v_at(std::uint32_t step, std::uint32_t neuron) { return static_cast<double>(step) + 1e-3 * neuron; }
+double u_at(std::uint32_t step, std::uint32_t neuron) { return -static_cast<double>(step) - 1e-3 * neuron; }
+double i_at(std::uint32_t step, std::uint32_t neuron) { return 0.5 * static_cast<double>(step * kNetworkSize + neuron); }
+
+// Records steps [0, steps) with synthetic values and checks the file.
+void round_trip(const std::string& label, izhnet::TraceConfig config, std::uint32_t steps)
+{
+    izhnet::AlignedVector<double> V(kNetworkSize);
+    izhnet::AlignedVector<double> U(kNetworkSize);
+    izhnet::AlignedVector<double> I(kNetworkSize);
+    std::vector<std::uint32_t> expected_steps;
+    {
+        izhnet::TraceRecorder recorder(config, kNetworkSize, kDt);
+        for (std::uint32_t step = 0; step < steps; ++step) {
+            for (std::uint32_t i = 0; i < kNetworkSize; ++i) {
+                V[i] = v_at(step, i);
+                U[i] = u_at(step, i);
+                I[i] = i_at(step, i);
+            }
+            if (recorder.due(step)) {
+                recorder.record(step, V, U, I);
+                expected_steps.push_back(step);
+            }
+        }
+        check(recorder.samples_recorded() == expected_steps.size(), label + ": samples counted");
+        recorder.close();
+    }
+
+    const izhnet::TraceData data = izhnet::read_trace_file(config.output_path);
+    check(data.neurons == config.neurons, label + ": neuron ids");
+    check(data.every_steps == config.every_steps, label + ": every_steps");
+    check(data.dt_ms == kDt, label + ": dt_ms");
+    check(data.steps == expected_steps, label + ": sample steps");
+    const std::size_t samples = expected_steps.size();
+    const std::size_t values = config.neurons.size() * samples;
+    check(data.V.size() == values && data.U.size() == values && data.I.size() == values, label + ": value counts");
+    if (data.V.size() != values || data.U.size() != values || data.I.size() != values) {
+        return;
+    }
+    bool values_match = true;
+    for (std::size_t k = 0; k < config.neurons.size(); ++k) {
+        const std::uint32_t neuron = config.neurons[k];
+        for (std::size_t j = 0; j < samples; ++j) {
+            const std::uint32_t step = expected_steps[j];
+            const std::size_t at = k * samples + j;
+            values_match = values_match && data.V[at] == v_at(step, neuron) && data.U[at] == u_at(step, neuron) &&
+                data.I[at] == i_at(step, neuron);
+        }
+    }
+    check(values_match, label + ": V, U and I of every sample");
+}
+
+bool rejected(const std::string& path)
+{
+    try {
+        izhnet::read_trace_file(path);
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int main()
+{
+    const std::filesystem::path dir = "trace_test_data";
+
+    izhnet::TraceConfig config;
+    config.neurons = { 9, 0, 49, 9 };
+    config.output_path = (dir / "trace.bin").string();
+    config.samples_per_block = 5;
+    config.block_count = 2;
+
+    // 67 samples: thirteen full blocks through a two-block ring, then a
+    // partial one.
+    config.every_steps = 3;
+    round_trip("every 3, wrapping", config, 200);
+
+    // Exactly four full blocks and no partial block.
+    config.every_steps = 1;
+    round_trip("every 1, full blocks", config, 20);
+
+    // Fewer samples than one block.
+    config.every_steps = 7;
+    round_trip("every 7, one partial block", config, 20);
+
+    // Larger ring than the run needs.
+    config.every_steps = 2;
+    config.block_count = 8;
+    round_trip("every 2, spare blocks", config, 31);
+
+    // Truncated and foreign files are rejected.
+    {
+        std::ifstream in(config.output_path, std::ios::binary);
+        const std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        const std::string damaged = (dir / "damaged.bin").string();
+        for (const std::size_t cut : { std::size_t { 8 }, bytes.size() - 12U }) {
+            std::ofstream out(damaged, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - cut));
+            out.close();
+            check(rejected(damaged), "trace truncated by " + std::to_string(cut) + " bytes rejected");
+        }
+        std::ofstream out(damaged, std::ios::binary | std::ios::trunc);
+        out << "not a trace file";
+        out.close();
+        check(rejected(damaged), "foreign file rejected");
+    }
+
+    bool out_of_range = false;
+    try {
+        izhnet::TraceConfig bad = config;
+        bad.neurons = { kNetworkSize };
+        izhnet::TraceRecorder recorder(bad, kNetworkSize, kDt);
+    } catch (const std::out_of_range&) {
+        out_of_range = true;
+    }
+    check(out_of_range, "traced neuron id outside the network rejected");
+
+    // A simulated trace holds the state at the start of each sampled step:
+    // its last sample equals the final state of a run stopped at that step.
+    {
+        constexpr std::uint32_t neuron_count = 400;
+        const izhnet::Network network = izhnet::Network::random_fixed_out_degree(neuron_count, 10, 0.1, 2.0, 9, false);
+        izhnet::SimulationConfig sim;
+        sim.sim.steps = 501;
+        sim.tonic_current = 8.0;
+        sim.trace.neurons = { 1, 100, 399 };
+        sim.trace.every_steps = 4;
+        sim.trace.samples_per_block = 16;
+        sim.trace.block_count = 2;
+        sim.trace.output_path = (dir / "sim.bin").string();
+        izhnet::NetworkState initial;
+        izhnet::initial_state(initial, neuron_count);
+        const izhnet::SimulationResult traced = izhnet::simulate_network(network, initial, sim);
+        const izhnet::TraceData data = izhnet::read_trace_file(sim.trace.output_path);
+        check(traced.stats.trace_samples == 126U && data.steps.size() == 126U && data.steps.back() == 500U,
+            "simulation traces every 4th step");
+
+        izhnet::SimulationConfig stopped = sim;
+        stopped.trace = {};
+        stopped.sim.steps = data.steps.back();
+        const izhnet::SimulationResult head = izhnet::simulate_network(network, initial, stopped);
+        bool match = true;
+        for (std::size_t k = 0; k < sim.trace.neurons.size(); ++k) {
+            const std::size_t at = (k + 1U) * data.steps.size() - 1U;
+            match = match && data.V[at] == head.final_state.V[sim.trace.neurons[k]] &&
+                data.U[at] == head.final_state.U[sim.trace.neurons[k]];
+        }
+        check(match, "last trace sample equals the state at its step");
+    }
+
+    std::error_code ignored;
+    std::filesystem::remove_all(dir, ignored);
+    return finish("trace files round-trip through read_trace_file");
+}